@@ -1,1650 +1,5704 @@
-//ConsoleGraphics V1.1
-//ISO C++ 11 or higher must be used to compile ConsoleGraphics.
-
-#include <vector>
-#include <limits>
-#include <cmath>
-#include <string>
-#include <fstream>
-#include <algorithm>
-#include <utility>
-
-#define NOMINMAX
-#include <windows.h>
-
-#ifdef CG_DEBUG
-	#include <iostream>
-#endif
-
-#ifndef int8
-	#define int8 int8_t
-	#define uint8 uint8_t
-	#define int16 int16_t
-	#define uint16 uint16_t
-	#define int32 int32_t
-	#define uint32 uint32_t
-	#define int64 int64_t
-	#define uint64 uint64_t
-#endif
-
-#ifndef CG_INCLUDE
-#define CG_INCLUDE
-
-//cg::BGR() is the same as RGB() from windows.h
-#undef RGB
-
-namespace cg
-{
-	class ConsoleGraphics;
-
-	uint32 RGB(uint8 r, uint8 g, uint8 b){return r | (g << 8) | (b << 16);
-	}
-	uint32 BGR(uint8 r, uint8 g, uint8 b){return RGB(b, g, r);
-	}
-	uint32 RGBA(uint8 r, uint8 g, uint8 b, uint8 a){return RGB(r, g, b) | (a << 24);
-	}
-	uint32 RGBA(uint32 rgb, uint8 a){return (rgb & 0x00FFFFFF) | (a << 24);
-	}
-	uint32 BGRA(uint8 r, uint8 g, uint8 b, uint8 a){return RGBA(b, g, r, a);
-	}
-	uint32 BGRA(uint32 bgr, uint8 a){return (bgr & 0x00FFFFFF) | (a << 24);
-	}
-	
-	//If isRGB == false, then input is assumed to be in the BGRA format
-	uint8 GetR(uint32 rgba, bool isRGB = false){return isRGB ? rgba : rgba >> 16;
-	}
-	uint8 GetG(uint32 rgba){return rgba >> 8;
-	}
-	uint8 GetB(uint32 rgba, bool isRGB = false){return isRGB ? rgba >> 16 : rgba;
-	}
-	uint8 GetA(uint32 rgba){return rgba >> 24;
-	}
-
-	uint32 blendPixel(uint32 dstRGB, uint32 srcRGB, uint8 srcA)
-	{
-		static uint16 r, g, b;
-
-		r = (cg::GetR(dstRGB) * (255 - srcA)) + (cg::GetR(srcRGB) * srcA);
-		g = (cg::GetG(dstRGB) * (255 - srcA)) + (cg::GetG(srcRGB) * srcA);
-		b = (cg::GetB(dstRGB) * (255 - srcA)) + (cg::GetB(srcRGB) * srcA);
-		r /= 255, g /= 255, b /= 255;
-
-		return cg::BGR((uint8)r, (uint8)g, (uint8)b);
-	}
-
-	enum class InterpolationMethod {None, NearestNeighbor, Bilinear, Bicubic, Bisinusoidal, AreaAveraging};
-	enum class ExtrapolationMethod {None, Repeat, Extend};
-
-	enum class FilterType {Grayscale, WeightedGrayscale, Invert, Custom = 255};
-
-	enum class RenderMode {BitBlt, BitBltInv, SetPixel, SetPixelVer, SetPixelInv, SetPixelVerInv};
-	enum class DrawType {Repeat, Resize};
-
-	class Image
-	{
-		//First element in pair is for rgb data, the second is for alpha
-		std::vector<std::pair<uint32, uint8>> pixels;
-		uint32 width, height, x = 0, y = 0;
-		float aspectRatio;
-
-	protected:
-		std::vector<std::pair<uint32, uint8>> ResizeData(std::vector<std::pair<uint32, uint8>>& pixels, uint32 newWidth, uint32 newHeight, InterpolationMethod m)
-		{
-			std::vector<std::pair<uint32, uint8>> data;
-			bool success = true;
-			float xScale = (float)width / (float)newWidth, yScale = (float)height / (float)newHeight;
-			data.resize(newWidth * newHeight);
-
-			switch (m)
-			{
-				default:
-				case InterpolationMethod::NearestNeighbor:
-				{
-					uint32 srcX, srcY;
-					for (uint32 y = 0; y < newHeight; ++y)
-					{
-						for (uint32 x = 0; x < newWidth; ++x)
-						{
-							srcX = x * xScale;
-							srcY = y * yScale;
-							data[(y * newWidth) + x] = pixels[(srcY * width) + srcX];
-						}
-					}
-				}
-				break;
-				
-				case InterpolationMethod::Bilinear:
-				case InterpolationMethod::Bicubic:
-				case InterpolationMethod::Bisinusoidal:
-				{
-					float srcX, srcY;
-					for (uint32 y = 0; y < newHeight; ++y)
-					{
-						for (uint32 x = 0; x < newWidth; ++x)
-						{
-							srcX = x * xScale;
-							srcX /= width;
-							srcY = y * yScale;
-							srcY /= height;
-							data[(y * newWidth) + x] = samplePixel(srcX, srcY, m, ExtrapolationMethod::Extend);
-						}
-					}
-				}
-				break;
-				
-				case InterpolationMethod::AreaAveraging:
-				{
-					if ((success = (xScale > 1.f && yScale > 1.f)))
-					{
-						uint16 pixW = xScale, pixH = yScale;
-						uint16 _w = pixW / 2, _h = pixH / 2;
-						pixW = std::max<uint16>(pixW, 2);
-						pixH = std::max<uint16>(pixH, 2);
-						uint32 avR, avG, avB, avA;
-						float alphaRatio;
-						uint32 srcX, srcY;
-						uint16 div = pixW * pixH;
-						
-						for (uint32 y = 0; y < newHeight; ++y)
-						{
-							for (uint32 x = 0; x < newWidth; ++x)
-							{
-								srcX = x * xScale;
-								srcY = y * yScale;
-								avR = 0, avG = 0, avB = 0, avA = 0;
-								
-								for (uint32 w = 0; w < pixW; ++w)
-								{
-									for (uint32 h = 0; h < pixH; ++h)
-									{
-										if (getPixel(srcX + w - _w, srcY + h - _h) != nullptr)
-										{
-											alphaRatio = pixels[((srcY + h - _h) * width) + (srcX + w - _w)].second / 255.f;
-											avR += cg::GetR(pixels[((srcY + h - _h) * width) + (srcX + w - _w)].first) * alphaRatio;
-											avG += cg::GetG(pixels[((srcY + h - _h) * width) + (srcX + w - _w)].first) * alphaRatio;
-											avB += cg::GetB(pixels[((srcY + h - _h) * width) + (srcX + w - _w)].first) * alphaRatio;
-											avA += pixels[((srcY + h - _h) * width) + (srcX + w - _w)].second;
-										} else {
-											alphaRatio = pixels[(srcY * width) + srcX].second / 255.f;
-											avR += cg::GetR(pixels[(srcY * width) + srcX].first) * alphaRatio;
-											avG += cg::GetG(pixels[(srcY * width) + srcX].first) * alphaRatio;
-											avB += cg::GetB(pixels[(srcY * width) + srcX].first) * alphaRatio;
-											avA += pixels[(srcY * width) + srcX].second;
-										}
-									}
-								}
-								
-								avR /= div, avG /= div, avB /= div, avA /= div;
-								data[(y * newWidth) + x] = std::make_pair(RGB(avB, avG, avR), avA);
-							}
-						}
-					} else data = this->pixels;
-				}
-				break;
-			}
-			if (success)
-			{
-				width = newWidth;
-				height = newHeight;
-			} else {
-				#ifdef CG_DEBUG
-					std::cerr << "CGIMG ERROR {this->ResizeData()}: New image size greater than original [" << width << char(158) << height << " -> " << newWidth << char(158) << newHeight << ", InterpolationMethod::AreaAveraging]" << std::endl;
-				#endif
-			}
-			return data;
-		}
-
-		void GetWindowSize(HWND w, uint32& width, uint32& height)
-		{
-			RECT window;
-			GetWindowRect(w, &window);
-
-			width = window.right - window.left;
-			height = window.bottom - window.top;
-			return;
-		}
-
-	public:
-		//Default constructor
-		Image()
-		{
-			width = 256;
-			height = 256;
-			aspectRatio = 1.f;
-			pixels.resize(width * height);
-			memset(pixels.data(), 0, pixels.size() * sizeof(std::pair<uint32, uint8>));
-		}
-		//Create an image and fill image with a colour
-		Image(uint32 width, uint32 height, uint32 rgb = 0, uint8 a = 255)
-		{
-			this->width = width;
-			this->height = height;
-			aspectRatio = (float)width / (float)height;
-			pixels.resize(width * height);
-			for (uint32 y = 0; y < height; ++y)
-			{
-				for (uint32 x = 0; x < width; ++x)
-				{
-					pixels[(y * width) + x] = std::make_pair(rgb, a);
-				}
-			}
-		}
-		//Load image from memory
-		Image(const uint32* data, uint32 width, uint32 height, bool alpha = false)
-		{
-			loadImageFromArray(data, width, height, alpha);
-		}
-		//Load image from memory
-		Image(const std::pair<uint32, uint8>* data, uint32 width, uint32 height)
-		{
-			loadImageFromArray(data, width, height);
-		}
-		//Load image from file
-		Image(const std::string fileName)
-		{
-			loadImage(fileName);
-		}
-
-		//Copy constructor
-		Image(const Image& image)
-		{
-			width = image.getWidth();
-			height = image.getHeight();
-			aspectRatio = (float)width / (float)height;
-			x = image.getPosX();
-			y = image.getPosY();
-
-			pixels.resize(width * height);
-			memcpy(&pixels[0], image.getPixelData(), width * height * sizeof(std::pair<uint32, uint8>));
-		}
-		Image& operator=(const Image& image)
-		{
-			if (&image != this)
-			{
-				width = image.getWidth();
-				height = image.getHeight();
-				aspectRatio = (float)width / (float)height;
-				x = image.getPosX();
-				y = image.getPosY();
-
-				pixels.resize(width * height);
-				memcpy(&pixels[0], image.getPixelData(), width * height * sizeof(std::pair<uint32, uint8>));
-			}
-			return *this;
-		}
-
-		std::pair<uint32, uint8>* operator[](uint32 i)
-		{
-			if (i < width * height){return &pixels[i];
-			} else return nullptr;
-		}
-
-		//Loads an image from the disk (currently only supports 24 and 32 bit BMP files)
-		bool loadImage(const std::string fileName)
-		{
-			std::string _fileName = fileName;
-			std::transform(_fileName.begin(), _fileName.end(), _fileName.begin(), [](char c)->char {return toupper(c);});
-
-			if (_fileName.find(".BMP") != std::string::npos)
-			{
-				std::ifstream readfile(fileName, std::ios::binary);
-				if (!readfile.is_open())
-				{
-					#ifdef CG_DEBUG
-						std::cerr << "CGIMG ERROR {this->loadImage()}: Failed to read file [" << fileName << ", errno=" << errno << "]" << std::endl;
-					#endif
-					return false;
-				}
-
-				//Read header
-				std::vector<uint8> header(14);
-				readfile.read((char*)&header[0], 14 * sizeof(uint8));
-				uint32 fileSize = *(uint32*)&header[0x02];
-				uint32 imgDataOffset = *(uint32*)&header[0x0A];
-				uint32 dibHeaderSize = imgDataOffset - header.size();
-				header.resize(imgDataOffset);
-				readfile.read((char*)&header[14], dibHeaderSize * sizeof(uint8));
-
-				int32 width = *(int32*)&header[0x12];
-				int32 height = *(int32*)&header[0x16];
-
-				uint16 bitesPerPixel = *(uint16*)&header[0x1C];
-				uint16 bytesPerPixel = bitesPerPixel / 8;
-				if (bytesPerPixel < 1){bytesPerPixel = 1;
-				}
-
-				//Check if valid before loading
-				if (header[0] != 'B' || header[1] != 'M')
-				{
-					#ifdef CG_DEBUG
-						std::cerr << "CGIMG ERROR {this->loadImage()}: Invalid BMP magic number [" << fileName << "]" << std::endl;
-					#endif
-					return false;
-				}
-
-				if (bytesPerPixel < 3)
-				{
-					#ifdef CG_DEBUG
-						std::cerr << "CGIMG ERROR {this->loadImage()}: Currently only supports 24 or 32 bit BMP files [" << fileName << "]" << std::endl;
-					#endif
-					return false;
-				}// else std::cout << "BytesPerPixel=" << bytesPerPixel << std::endl;
-
-				this->width = width;
-				this->height = abs(height);
-				aspectRatio = (float)this->width / (float)this->height;
-				pixels.resize(this->width * this->height);
-
-				const uint32 rowSize = width * bytesPerPixel, paddingSize = (4 - (width % 4)) % 4;
-				std::cout << (int)readfile.tellg() << std::endl;
-				std::vector<uint8> imgData(fileSize - imgDataOffset);
-				readfile.read(reinterpret_cast<char*>(&imgData[0]), imgData.size() * sizeof(uint8));
-
-				for (uint32 y = 0; y < this->height; ++y)
-				{
-					for (uint32 x = 0; x < width; ++x)
-					{
-						uint32 index = ((rowSize + paddingSize) * y) + (x * bytesPerPixel);
-						uint8 red = imgData[index + 2];
-						uint8 green = imgData[index + 1];
-						uint8 blue = imgData[index];
-						uint8 alpha = (bytesPerPixel == 3 ? 255 : imgData[index + 3]);
-						pixels[(y * this->width) + x] = std::make_pair(cg::BGR(red, green, blue), alpha);
-					}
-				}
-
-				readfile.close();
-				if (height > 0){flipVertically();
-				}
-			} else return false;
-			return true;
-		}
-
-		//Loads image from memory, format = 0xAARRGGBB
-		void loadImageFromArray(const uint32* arr, uint32 width, uint32 height, bool alpha = false)
-		{
-			pixels.resize(width * height);
-			this->width = width;
-			this->height = height;
-			this->aspectRatio = (float)width / (float)height;
-
-			for (uint32 y = 0; y < height; ++y)
-			{
-				for (uint32 x = 0; x < width; ++x)
-				{
-					const uint32& pixel = arr[(y * width) + x];
-					uint32 rgb = cg::BGR(cg::GetR(pixel), cg::GetG(pixel), cg::GetB(pixel));
-					uint8 a = alpha ? cg::GetA(pixel) : 255;
-					pixels[(y * width) + x] = std::make_pair(rgb, a);
-				}
-			}
-			return;
-		}
-		//Loads image from memory, format = {0x00RRGGBB, 0xAA}
-		void loadImageFromArray(const std::pair<uint32, uint8>* arr, uint32 width, uint32 height)
-		{
-			pixels.resize(width * height);
-			this->width = width;
-			this->height = height;
-			this->aspectRatio = (float)width / (float)height;
-
-			for (uint32 y = 0; y < height; ++y)
-			{
-				for (uint32 x = 0; x < width; ++x)
-				{
-					const uint32& rgb = arr[(y * width) + x].first;
-					const uint8& a = arr[(y * width) + x].second;
-					pixels[(y * width) + x] = std::make_pair(cg::BGR(cg::GetR(rgb), cg::GetG(rgb), cg::GetB(rgb)), a);
-				}
-			}
-			return;
-		}
-
-		//Saves image to disk (ver parameter currently unused)
-		void saveImage(const std::string fileName, uint32 ver = 0)
-		{
-			std::string _fileName = fileName;
-			std::transform(_fileName.begin(), _fileName.end(), _fileName.begin(), [](char c)->char {return toupper(c);});
-
-			if (_fileName.find(".BMP"))
-			{
-				std::vector<uint8> bmpHeader(14), dibHeader(40), pixData;
-				memcpy(&bmpHeader[0x00], "BM", 2 * sizeof(char));
-				uint32 val = bmpHeader.size() + dibHeader.size();
-				memcpy(&bmpHeader[0x0A], &val, sizeof(uint32));
-
-				val = 40;
-				int32 width = this->width;
-				int32 height = this->height;
-				height = -height;
-				memcpy(&dibHeader[0x00], &val, sizeof(uint32));
-				memcpy(&dibHeader[0x04], &width, sizeof(int32));
-				memcpy(&dibHeader[0x08], &height, sizeof(int32));
-				val = 1;
-				memcpy(&dibHeader[0x0C], &val, sizeof(uint16));
-				val = 32;
-				memcpy(&dibHeader[0x0E], &val, sizeof(uint16));
-
-				const uint16 bytesPerPixel = 4;
-				const uint32 rowSize = this->width * bytesPerPixel, paddingSize = (4 - (this->width % 4)) % 4;
-				const uint8 paddingVal = 0x00;
-				pixData.reserve(this->height * (rowSize + paddingSize));
-
-				for (uint32 y = 0; y < this->height; y++)
-				{
-					for (uint32 x = 0; x < this->width; x++)
-					{
-						//BBGGRRAA
-						auto p = accessPixel(x, y);
-						pixData.push_back(GetB(p->first));
-						pixData.push_back(GetG(p->first));
-						pixData.push_back(GetR(p->first));
-						pixData.push_back((p->second));
-					}
-
-					pixData.resize(pixData.size() + paddingSize, paddingVal);
-				}
-
-				//fileSize
-				val = bmpHeader.size() + dibHeader.size() + pixData.size();
-				memcpy(&bmpHeader[0x02], &val, sizeof(uint32));
-				val = pixData.size();
-				memcpy(&dibHeader[0x14], &val, sizeof(uint32));
-
-				std::ofstream writeFile(fileName.c_str(), std::ios::binary);
-				if (writeFile.is_open())
-				{
-					writeFile.write((char*)&bmpHeader[0], bmpHeader.size() * sizeof(char));
-					writeFile.write((char*)&dibHeader[0], dibHeader.size() * sizeof(char));
-					writeFile.write((char*)&pixData[0], pixData.size() * sizeof(char));
-					writeFile.close();
-				}
-			}
-			else {
-				#ifdef CG_DEBUG
-					std::cerr << "CGIMG ERROR {this->saveImage()}: Image type not supported. [" << fileName << "]" << std::endl;
-				#endif
-			}
-
-			return;
-		}
-
-		//FilterType::Invert = Invert all colours
-		//FilterType::Custom = Custom (pass in a function pointer, or lamda)
-		//Applies a function to all pixels in the image, funcData is not required
-		void filter(FilterType filterType, void (*funcPtr)(std::pair<uint32, uint8>*, void*) = nullptr, void* funcData = nullptr)
-		{
-			switch (filterType)
-			{
-				default:
-				case FilterType::Grayscale:
-				{
-					uint8 r, g, b;
-					uint16 c;
-					for (uint32 i = 0; i < pixels.size(); ++i)
-					{
-						r = cg::GetR(pixels[i].first);
-						g = cg::GetG(pixels[i].first);
-						b = cg::GetB(pixels[i].first);
-						c = (r + g + b) / 3;
-						pixels[i].first = cg::BGR(c, c, c);
-					}
-				}
-				break;
-				
-				case FilterType::WeightedGrayscale:
-				{
-					uint8 r, g, b, c;
-					for (uint32 i = 0; i < pixels.size(); ++i)
-					{
-						r = cg::GetR(pixels[i].first);
-						g = cg::GetG(pixels[i].first);
-						b = cg::GetB(pixels[i].first);
-						c = (r * 0.3f) + (g * 0.59f) + (b * 0.11f);
-						pixels[i].first = cg::BGR(c, c, c);
-					}
-				}
-				break;
-
-				case FilterType::Invert:
-				{
-					for (uint32 i = 0; i < pixels.size(); ++i)
-					{
-						pixels[i].first = pixels[i].first ^ 0xFFFFFF;
-					}
-				}
-				break;
-
-				case FilterType::Custom:
-				{
-					for (uint32 i = 0; i < pixels.size(); ++i)
-					{
-						funcPtr(&pixels[i], funcData);
-					}
-				}
-				break;
-			}
-			return;
-		}
-
-		//Returns the width of the image
-		uint32 getWidth(void) const {return width;
-		}
-		//Returns the height of the image
-		uint32 getHeight(void) const {return height;
-		}
-
-		//Sets the position of where the image will be drawn to (co-ordinates can't be negative)
-		void setPos(uint32 x, uint32 y)
-		{
-			this->x = x;
-			this->y = y;
-			return;
-		}
-		//Moves the position of the image (co-ordinates can't be negative)
-		void move(uint32 x, uint32 y)
-		{
-			this->x += x;
-			this->y += y;
-			return;
-		}
-
-		//Returns X co-ordinate of the image
-		uint32 getPosX(void) const {return x;
-		}
-		//Returns Y co-ordinate of the image
-		uint32 getPosY(void) const {return y;
-		}
-
-		//Flips an image on the X-axis
-		void flipVertically(void)
-		{
-			uint32 halfHeight = height / 2;
-			for (uint32 y = 0; y < halfHeight; ++y)
-			{
-				for (uint32 x = 0; x < width; ++x)
-				{
-					std::swap(pixels[(y * width) + x], pixels[((height - y - 1) * width) + x]);
-				}
-			}
-			return;
-		}
-		//Flips an image on the Y-axis
-		void flipHorizontally(void)
-		{
-			uint32 halfWidth = width / 2;
-			for (uint32 y = 0; y < height; ++y)
-			{
-				for (uint32 x = 0; x < halfWidth; ++x)
-				{
-					std::swap(pixels[(y * width) + x], pixels[(y * width) + (width - x - 1)]);
-				}
-			}
-			return;
-		}
-
-		//Return a read only pointer to pixel array
-		const std::pair<uint32, uint8>* getPixelData(void) const {return this->pixels.data();
-		}
-
-		//If either newWidth or newHeight == 0, the image's aspect ratio is maintained
-		//Resamples image to specified dimensions using chosen interpolation method
-		void resize(uint32 newWidth, uint32 newHeight, InterpolationMethod m = InterpolationMethod::NearestNeighbor)
-		{
-			if (newWidth == 0)
-			{
-				pixels = ResizeData(pixels, newHeight * aspectRatio, newHeight, m);
-				width = newHeight * aspectRatio;
-				height = newHeight;
-			}
-			else if (newHeight == 0)
-			{
-				pixels = ResizeData(pixels, newWidth, newWidth / aspectRatio, m);
-				width = newWidth;
-				height = newWidth / aspectRatio;
-			}
-			else {
-				pixels = ResizeData(pixels, newWidth, newHeight, m);
-				width = newWidth;
-				height = newHeight;
-				aspectRatio = (float)width / (float)height;
-			}
-			return;
-		}
-
-		//Resamples image by a scale factor using a chosen interpolation method, aspect ratio is maintained
-		void scale(float s, InterpolationMethod m = InterpolationMethod::NearestNeighbor)
-		{
-			if (s > 0.f)
-			{
-				resize(width * s, height * s, m);
-			}
-			return;
-		}
-
-		//Resamples image by a scale factor in each axis using a chosen interpolation method, aspect may be changed
-		void scale(float sx, float sy, InterpolationMethod m = InterpolationMethod::NearestNeighbor)
-		{
-			if (sx > 0.f && sy > 0.f)
-			{
-				resize(width * sx, height * sy, m);
-			}
-			return;
-		}
-
-		//Returns a pointer to a pixel without checking if it exists 
-		std::pair<uint32, uint8>* accessPixel(uint32 x, uint32 y){return &pixels[(y * width) + x];
-		}
-
-		//Returns a pointer to a pixel, if pixel doesn't exist "nullptr" will be returned
-		std::pair<uint32, uint8>* getPixel(uint32 x, uint32 y)
-		{
-			if (x < width && y < height){return &pixels[(y * width) + x];
-			} else return nullptr;
-		}
-
-		//Returns a copy of pixel at a point
-		std::pair<uint32, uint8> samplePixel(float x, float y, InterpolationMethod im = InterpolationMethod::NearestNeighbor, ExtrapolationMethod em = ExtrapolationMethod::Repeat) const
-		{
-			std::pair<uint32, uint8> pixel;
-			uint8 r[] = {0x00, 0x00, 0x00, 0x00};
-			uint8 g[] = {0x00, 0x00, 0x00, 0x00};
-			uint8 b[] = {0x00, 0x00, 0x00, 0x00};
-			uint8 a[] = {0xFF, 0xFF, 0xFF, 0xFF};
-
-			bool inBounds = (im != InterpolationMethod::AreaAveraging);
-			bool badX = (x < 0.f || x > 1.f);
-			bool badY = (y < 0.f || y > 1.f);
-
-			if (badX || badY)
-			{
-				switch (em)
-				{
-					case cg::ExtrapolationMethod::None:
-						inBounds = false;
-						pixel = std::make_pair(0x00000000, 0x00);
-						break;
-
-					case cg::ExtrapolationMethod::Repeat:
-						x = (x < 0.f ? x + 1.f : x - std::floor(x));
-						y = (y < 0.f ? y + 1.f : y - std::floor(y));
-						break;
-
-					case cg::ExtrapolationMethod::Extend:
-						x = std::min(std::max(0.f, x), 1.f);
-						y = std::min(std::max(0.f, y), 1.f);
-						break;
-				}
-			}
-
-			float posX = x * (width - 1), posY = y * (height - 1);
-			uint32 posXLower = posX, posXUpper = 0;
-			uint32 posYLower = posY, posYUpper = 0;
-			float valX = posX - std::floor(posX), valY = posY - std::floor(posY); //values used for interpolation
-
-			if (im == InterpolationMethod::NearestNeighbor || im == InterpolationMethod::None)
-			{
-				inBounds = false;
-				pixel = pixels[(std::round(posY) * width) + std::round(posX)];
-			}
-
-			if (inBounds)
-			{
-				switch (em)
-				{
-					case cg::ExtrapolationMethod::None:
-						break;
-
-					case cg::ExtrapolationMethod::Repeat:
-						posXUpper = (posXLower + 1) % width;
-						posYUpper = (posYLower + 1) % height;
-						break;
-
-					case cg::ExtrapolationMethod::Extend:
-						posXUpper = std::min<uint32>(std::max<uint32>(0, posXLower + 1), width - 1);
-						posYUpper = std::min<uint32>(std::max<uint32>(0, posYLower + 1), height - 1);
-						break;
-				}
-
-				uint32 index = (posYLower * width) + posXLower;
-				r[0] = cg::GetR(pixels[index].first);
-				g[0] = cg::GetG(pixels[index].first);
-				b[0] = cg::GetB(pixels[index].first);
-				a[0] = pixels[index].second;
-
-				index = (posYLower * width) + posXUpper;
-				r[1] = cg::GetR(pixels[index].first);
-				g[1] = cg::GetG(pixels[index].first);
-				b[1] = cg::GetB(pixels[index].first);
-				a[1] = pixels[index].second;
-
-				index = (posYUpper * width) + posXLower;
-				r[2] = cg::GetR(pixels[index].first);
-				g[2] = cg::GetG(pixels[index].first);
-				b[2] = cg::GetB(pixels[index].first);
-				a[2] = pixels[index].second;
-
-				index = (posYUpper * width) + posXUpper;
-				r[3] = cg::GetR(pixels[index].first);
-				g[3] = cg::GetG(pixels[index].first);
-				b[3] = cg::GetB(pixels[index].first);
-				a[3] = pixels[index].second;
-
-				int16 dR, dG, dB, dA;
-				float val, scale = -6.f; //for bicubic
-
-				switch (im)
-				{
-					case cg::InterpolationMethod::Bilinear:
-						dR = r[1] - r[0];
-						dG = g[1] - g[0];
-						dB = b[1] - b[0];
-						dA = a[1] - a[0];
-						r[0] = r[0] + (valX * dR); //Combined rX1
-						g[0] = g[0] + (valX * dG); //Combined gX1
-						b[0] = b[0] + (valX * dB); //Combined bX1
-						a[0] = a[0] + (valX * dA); //Combined aX1
-
-						dR = r[3] - r[2];
-						dG = g[3] - g[2];
-						dB = b[3] - b[2];
-						dA = a[3] - a[2];
-						r[1] = r[2] + (valX * dR); //Combined rX2
-						g[1] = g[2] + (valX * dG); //Combined gX2
-						b[1] = b[2] + (valX * dB); //Combined bX2
-						a[1] = a[2] + (valX * dA); //Combined aX2
-
-						dR = r[1] - r[0];
-						dG = g[1] - g[0];
-						dB = b[1] - b[0];
-						dA = a[1] - a[0];
-						r[0] = r[0] + (valY * dR); //Combined rY
-						g[0] = g[0] + (valY * dG); //Combined gY
-						b[0] = b[0] + (valY * dB); //Combined bY
-						a[0] = a[0] + (valY * dA); //Combined aY
-
-						pixel = std::make_pair(cg::BGR(r[0], g[0], b[0]), a[0]);
-						break;
-
-					case cg::InterpolationMethod::Bicubic: //Doesn't work correctly. "Bisinusiodal" should provide similar results.
-						val = (0.333f * std::powf(valX, 3.f)) + (0.5f * std::powf(valX, 2.f));
-						val *= scale;
-						dR = r[1] - r[0];
-						dG = g[1] - g[0];
-						dB = b[1] - b[0];
-						dA = a[1] - a[0];
-						r[0] = (dR * val) + r[0]; //Combined rX1
-						g[0] = (dG * val) + g[0]; //Combined gX1
-						b[0] = (dB * val) + b[0]; //Combined bX1
-						a[0] = (dA * val) + a[0]; //Combined aX1
-
-						dR = r[3] - r[2];
-						dG = g[3] - g[2];
-						dB = b[3] - b[2];
-						dA = a[3] - a[2];
-						r[1] = (dR * val) + r[2]; //Combined rX2
-						g[1] = (dG * val) + g[2]; //Combined gX2
-						b[1] = (dB * val) + b[2]; //Combined bX2
-						a[1] = (dA * val) + a[2]; //Combined aX2
-
-						val = (0.333f * std::pow(valY, 3.f)) + (0.5f * std::pow(valY, 2.f));
-						val *= scale;
-						dR = r[1] - r[0];
-						dG = g[1] - g[0];
-						dB = b[1] - b[0];
-						dA = a[1] - a[0];
-						r[0] = (dR * val) + r[0]; //Combined rY
-						g[0] = (dG * val) + g[0]; //Combined gY
-						b[0] = (dB * val) + b[0]; //Combined bY
-						a[0] = (dA * val) + a[0]; //Combined aY
-
-						pixel = std::make_pair(cg::BGR(r[0], g[0], b[0]), a[0]);
-						break;
-
-					case cg::InterpolationMethod::Bisinusoidal:
-						val = (-0.5f * std::cosf(3.14159f * valX)) + 0.5f;
-						dR = r[1] - r[0];
-						dG = g[1] - g[0];
-						dB = b[1] - b[0];
-						dA = a[1] - a[0];
-						r[0] = (dR * val) + r[0]; //Combined rX1
-						g[0] = (dG * val) + g[0]; //Combined gX1
-						b[0] = (dB * val) + b[0]; //Combined bX1
-						a[0] = (dA * val) + a[0]; //Combined aX1
-
-						dR = r[3] - r[2];
-						dG = g[3] - g[2];
-						dB = b[3] - b[2];
-						dA = a[3] - a[2];
-						r[1] = (dR * val) + r[2]; //Combined rX2
-						g[1] = (dG * val) + g[2]; //Combined gX2
-						b[1] = (dB * val) + b[2]; //Combined bX2
-						a[1] = (dA * val) + a[2]; //Combined aX2
-
-						val = (-0.5f * std::cosf(3.14159f * valY)) + 0.5f;
-						dR = r[1] - r[0];
-						dG = g[1] - g[0];
-						dB = b[1] - b[0];
-						dA = a[1] - a[0];
-						r[0] = (dR * val) + r[0]; //Combined rY
-						g[0] = (dG * val) + g[0]; //Combined gY
-						b[0] = (dB * val) + b[0]; //Combined bY
-						a[0] = (dA * val) + a[0]; //Combined aY
-
-						pixel = std::make_pair(cg::BGR(r[0], g[0], b[0]), a[0]);
-						break;
-
-					default:
-						break;
-				}
-			}
-			
-			return pixel;
-		}
-
-		void setPixel(uint32 x, uint32 y, uint32 rgb, uint8 a = 255)
-		{
-			if (x < width && y < height)
-			{
-				pixels[(y * width) + x] = std::make_pair(rgb, a);
-			}
-			return;
-		}
-
-		//Sets all alpha values in the image
-		void setAlpha(uint8 a)
-		{
-			for (uint32 i = 0; i < pixels.size(); ++i)
-			{
-				pixels[i].second = a;
-			}
-			return;
-		}
-
-		//Replaces the alpha value of all pixels with certain colour
-		void setColourToAlpha(uint32 rgb, uint8 a = 0)
-		{
-			for (uint32 i = 0; i < pixels.size(); ++i)
-			{
-				if (pixels[i].first == rgb){pixels[i].second = a;
-				}
-			}
-			return;
-		}
-
-		//Change the image's dimensions (does not resample image)
-		void setSize(uint32 newWidth, uint32 newHeight, bool clearData = false)
-		{
-			auto temp = pixels;
-			pixels.clear();
-			pixels.resize(newWidth * newHeight);
-			if (!clearData)
-			{
-				for (uint32 y = 0; y < height; y++)
-				{
-					for (uint32 x = 0; x < width; x++)
-					{
-						pixels[(y * newWidth) + x] = temp[(y * width) + x];
-					}
-				}
-			}
-			width = newWidth;
-			height = newHeight;
-			aspectRatio = (float)width / (float)height;
-			return;
-		}
-
-		//Copy a section from a section of an image, to another (currently very slow)
-		void copy(Image& image, uint32 dstX, uint32 dstY, uint32 srcX, uint32 srcY, uint32 width, uint32 height, bool alpha = false)
-		{
-			for (uint32 iy = 0; iy < height; iy++)
-			{
-				for (uint32 ix = 0; ix < width; ix++)
-				{
-					if (getPixel(ix + dstX, iy + dstY) != nullptr && image.getPixel(ix + srcX, iy + srcY) != nullptr)
-					{
-						pixels[((iy + dstY) * this->width) + (ix + dstX)] = std::make_pair(image.getPixelData()[((iy + srcY) * image.getWidth()) + (ix + srcX)].first, alpha ? image.getPixelData()[((iy + srcY) * image.getWidth()) + (ix + srcX)].second : 255);
-					}
-				}
-			}
-			return;
-		}
-
-		//Draws a section from an section, to another
-		void blendImage(Image& image, uint32 dstX, uint32 dstY, uint32 srcX, uint32 srcY, uint32 width, uint32 height, bool keepAlpha = true, bool mask = true)
-		{
-			uint8 tempA;
-			for (uint32 iy = 0; iy < height; iy++)
-			{
-				for (uint32 ix = 0; ix < width; ix++)
-				{
-					if (getPixel(ix + dstX, iy + dstY) != nullptr && image.getPixel(ix + srcX, iy + srcY) != nullptr)
-					{
-						tempA = pixels[((iy + dstY) * this->width) + (ix + dstX)].second;
-						std::pair<uint32, uint8> srcRGB = image.getPixelData()[((iy + srcY) * image.getWidth()) + (ix + srcX)], & dstRGB = pixels[((iy + dstY) * this->width) + (ix + dstX)];
-						dstRGB.first = blendPixel(dstRGB.first, srcRGB.first, srcRGB.second);
-						dstRGB.second = keepAlpha ? dstRGB.second : srcRGB.second;
-						if (mask && srcRGB.second == 0){dstRGB.second = tempA;
-						}
-					}
-				}
-			}
-			return;
-		}
-	};
-
-	struct Size
-	{
-		uint32 width, height;
-
-		Size()
-		{
-			width = 0, height = 0;
-		}
-		Size(uint32 width, uint32 height)
-		{
-			this->width = width;
-			this->height = height;
-		}
-	};
-
-	struct SubImageData
-	{
-		Size size;
-		uint32 srcX, srcY, dstX, dstY;
-		bool isVertical, transparency;
-
-		SubImageData()
-		{
-			srcX = 0, srcY = 0;
-			dstX = 0, dstY = 0;
-			isVertical = false;
-			transparency = false;
-		}
-		SubImageData(uint32 srcX, uint32 srcY, uint32 dstX, uint32 dstY, uint32 width, uint32 height, bool isVertical, bool transparency = false)
-		{
-			this->srcX = srcX;
-			this->srcY = srcY;
-			this->dstX = dstX;
-			this->dstY = dstY;
-			size.width = width;
-			size.height = height;
-			this->isVertical = isVertical;
-			this->transparency = transparency;
-		}
-	};
-
-	class Text
-	{
-		Image* font = nullptr;
-		std::string text;
-		uint32 charWidth, charHeight;
-		Image textImage;
-
-		protected:
-	
-		void getTextSize(std::string text, uint32& width, uint32& height)
-		{
-			width = 0;
-			height = 1;
-
-			std::vector<uint32> sizes;
-
-			for (uint32 i = 0; i < text.size(); ++i)
-			{
-				if (text[i] == '\n')
-				{
-					sizes.push_back(width);
-					width = 0;
-					++height;
-				} else ++width;
-			}
-
-			if (height != 1)
-			{
-				for (uint32 i = 0; i < sizes.size(); ++i)
-				{
-					if (width < sizes[i]){width = sizes[i];
-					}
-				}
-			}
-			width = std::max<uint32>(width, 1);
-		}
-	public:
-		Text()
-		{
-			this->charWidth = 0;
-			this->charHeight = 0;
-		}
-		Text(Image* fontImage, uint32 charWidth, uint32 charHeight, const std::string text)
-		{
-			this->font = fontImage;
-			this->charWidth = charWidth;
-			this->charHeight = charHeight;
-			this->text = text;
-			setText(text);
-		}
-		~Text()
-		{
-			this->font = nullptr;
-		}
-
-		//Pass in image pointer with font loaded to save memory
-		void setFont(Image* fontImage, uint32 charWidth, uint32 charHeight)
-		{
-			font = fontImage;
-			this->charWidth = charWidth;
-			this->charHeight = charHeight;
-			return;
-		}
-		void setCharSize(uint32 charWidth, uint32 charHeight)
-		{
-			this->charWidth = charWidth;
-			this->charHeight = charHeight;
-			return;
-		}
-		void setPos(uint32 x, uint32 y)
-		{
-			textImage.setPos(x, y);
-			return;
-		}
-		uint32 getPosX(void){return textImage.getPosX();
-		}
-		uint32 getPosY(void){return textImage.getPosY();
-		}
-
-		void setText(const std::string text, uint32 compX = 0, uint32 compY = 0)
-		{
-			this->text = text;
-			uint32 textWidth, textHeight;
-			getTextSize(text, textWidth, textHeight);
-			textImage.setSize((textWidth * charWidth) - (compX * textWidth), (textHeight * charHeight) - (compY * textHeight), true);
-			uint32 srcX = 0, srcY = 0, dstX = 0, dstY = 0;
-
-			for (uint32 i = 0; i < text.size(); ++i)
-			{
-				uint8 c = text[i];
-				srcX = c * charWidth;
-
-				switch (c)
-				{
-					case '\n':
-						dstX = 0;
-						dstY++;
-						break;
-
-					default:
-						textImage.copy(*font, (dstX * charWidth) - (compX * dstX), (dstY * charHeight) - (compY * dstY), srcX, 0, charWidth, charHeight, true);
-						dstX++;
-						break;
-				}
-			}
-			return;
-		}
-
-		std::string getText(void){return text;
-		}
-		Image& getTextImage(void){return textImage;
-		}
-		Image* getFontImage(void){return font;
-		}
-
-		uint32 getCharWidth(void){return charWidth;
-		}
-		uint32 getCharHeight(void){return charHeight;
-		}
-		uint32 getWidth(void){return textImage.getWidth();
-		}
-		uint32 getHeight(void){return textImage.getHeight();
-		}
-	};
-
-	class ConsoleGraphics
-	{
-		std::vector<uint32> pixels;
-		uint32 width, height, startX, startY, consoleWidth, consoleHeight;
-		RenderMode renderMode;
-		HBITMAP pixelBitmap;
-		HDC targetDC, tempDC;
-		bool alphaMode;
-		uint16 pixelSize;
-		bool enableShaders;
-		std::vector<void(*)(uint32*, uint32, uint32, uint32, uint32, void*)> shaderList;
-		std::vector<void*> shaderDataList;
-		std::string title;
-		float outputScale = 1.f;
-		//"shaderList" function struct
-		//Arg 1 = Pointer to current pixel
-		//Arg 2 = Current X
-		//Arg 3 = Current Y
-		//Arg 4 = Number of operations
-		//Arg 5 = Extra data
-	protected:
-		void initialise(void)
-		{
-			targetDC = GetDC(GetConsoleWindow());
-			tempDC = CreateCompatibleDC(targetDC);
-
-			renderMode = RenderMode::BitBlt;
-			startX = 0;
-			startY = 0;
-			pixelSize = 1;
-			outputScale = 1.f;
-
-			alphaMode = false;
-			enableShaders = false;
-
-			return;
-		}
-
-		//Improve this
-		void RemoveScrollbar(void)
-		{
-			ShowScrollBar(GetConsoleWindow(), SB_BOTH, FALSE);
-			return;
-		}
-
-		void GetWindowSize(HWND w, uint32& width, uint32& height)
-		{
-			RECT window;
-			GetWindowRect(w, &window);
-
-			width = window.right - window.left;
-			height = window.bottom - window.top;
-			return;
-		}
-
-		void SetConsoleSize(uint32 width, uint32 height)
-		{
-			RECT window;
-			GetWindowRect(GetConsoleWindow(), &window);
-			SetWindowPos(GetConsoleWindow(), HWND_TOP, window.left, window.top, width, height, SWP_SHOWWINDOW);
-			RemoveScrollbar();
-			return;
-		}
-
-		std::vector<uint32> ResizeDataNearestNeighbor(std::vector<uint32>& pixels, uint32 newWidth, uint32 newHeight)
-		{
-			std::vector<uint32> data;
-			float xScale = (float)width / (float)newWidth, yScale = (float)height / (float)newHeight;
-			data.resize(newWidth * newHeight);
-
-			uint32 srcX, srcY;
-			for (uint32 y = 0; y < newHeight; ++y)
-			{
-				for (uint32 x = 0; x < newWidth; ++x)
-				{
-					srcX = x * xScale;
-					srcY = y * yScale;
-					data[(y * newWidth) + x] = pixels[(srcY * width) + srcX];
-				}
-			}
-
-			width = newWidth;
-			height = newHeight;
-			return data;
-		}
-
-		uint32& accessBuffer(uint32 x, uint32 y){return pixels[(y * width) + x];
-		}
-		uint32& accessBuffer(uint32 index){return pixels[index];
-		}
-
-	public:
-		ConsoleGraphics()
-		{
-			initialise();
-			GetWindowSize(GetConsoleWindow(), consoleWidth, consoleHeight);
-			RemoveScrollbar();
-			width = consoleWidth;
-			height = consoleHeight;
-			pixels.resize(width * height);
-		}
-
-		ConsoleGraphics(uint32 width, uint32 height, bool setSize = false, uint16 pixelSize = 1, bool pixelMode = false)
-		{
-			initialise();
-			this->pixelSize = std::max<uint16>(pixelSize, 1);
-			GetWindowSize(GetConsoleWindow(), consoleWidth, consoleHeight);
-			this->width = width / (!pixelMode ? 1 : pixelSize);
-			this->height = height / (!pixelMode ? 1 : pixelSize);
-
-			if (setSize || pixelMode)
-			{
-				//Get windows version and add offset to window size
-				uint16 windowWidthOffset = 0, windowHeightOffset = 0;
-				SetConsoleSize(consoleWidth + windowWidthOffset, consoleHeight + windowHeightOffset);
-			}
-
-			pixels.resize(this->width * this->height);
-		}
-
-		bool display(void)
-		{
-			bool returnValue = true;
-
-			if (enableShaders)
-			{
-				for (uint8 i = 0; i < shaderList.size(); ++i)
-				{
-					for (uint32 y = 0; y < height; ++y)
-					{
-						for (uint32 x = 0; x < width; ++x)
-						{
-							shaderList[i](&pixels[(y * width) + x], width, height, x, y, shaderDataList[i]);
-						}
-					}
-				}
-			}
-
-			switch (renderMode)
-			{
-				default:
-				case RenderMode::BitBltInv:
-				case RenderMode::BitBlt:
-					pixelBitmap = CreateBitmap(width, height, 1, 8 * 4, &pixels[0]);
-					if (returnValue = (pixelBitmap == NULL))
-					{
-						#ifdef CG_DEBUG
-							std::cerr << "CGOUT ERROR {this->display()}: CreateBitmap() returned 'NULL' [GetLastError()=" << GetLastError() << "]" << std::endl;
-						#endif
-
-						return !returnValue;
-					}
-					SelectObject(tempDC, pixelBitmap);
-					returnValue = StretchBlt(targetDC, startX, startY, consoleWidth * outputScale, consoleHeight * outputScale, tempDC, 0, 0, width, height, renderMode == RenderMode::BitBlt ? SRCCOPY : NOTSRCCOPY);
-					if (!returnValue)
-					{
-						#ifdef CG_DEBUG
-							std::cerr << "CGOUT ERROR {this->display()}: StretchBlt() returned 'false' [GetLastError()=" << GetLastError() << "]" << std::endl;
-						#endif
-						
-						return !returnValue;
-					}
-					DeleteObject(pixelBitmap);
-					break;
-
-				case RenderMode::SetPixelInv:
-				case RenderMode::SetPixel:
-					for (uint32 y = 0; y < consoleHeight; ++y)
-					{
-						for (uint32 x = 0; x < consoleWidth; ++x)
-						{
-							uint32 p = _byteswap_ulong(pixels[((y / pixelSize) * width) + (x / pixelSize)]) >> 8;
-							SetPixelV(targetDC, x, y, renderMode == RenderMode::SetPixel ? p : p ^ 0x00FFFFFF); //^ 0x00FFFFFF << inverts colours
-						}
-					}
-					break;
-
-				case RenderMode::SetPixelVer:
-				case RenderMode::SetPixelVerInv:
-					for (uint32 x = 0; x < consoleWidth; ++x)
-					{
-						for (uint32 y = 0; y < consoleHeight; ++y)
-						{
-							uint32 p = _byteswap_ulong(pixels[((y / pixelSize) * width) + (x / pixelSize)]) >> 8;
-							SetPixelV(targetDC, x, y, renderMode == RenderMode::SetPixelVer ? p : p ^ 0x00FFFFFF);
-						}
-					}
-					break;
-			}
-
-			return returnValue;
-		}
-
-		void setRenderMode(RenderMode mode)
-		{
-			renderMode = mode;
-			return;
-		}
-		void enableAlpha(void)
-		{
-			this->alphaMode = true;
-			return;
-		}
-		void disableAlpha(void)
-		{
-			this->alphaMode = false;
-			return;
-		}
-
-		//Clear window with grayscale value
-		void clear(uint8 c = 0x00)
-		{
-			memset(pixels.data(), c, pixels.size() * sizeof(uint32));
-			return;
-		}
-
-		void setPixel(uint32 x, uint32 y, uint32 rgb)
-		{
-			if (x < width && y < height){pixels[(y * width) + x] = rgb;
-			}
-			return;
-		}
-		void drawPixel(uint32 x, uint32 y, uint32 rgb, uint8 a)
-		{
-			if (x < width && y < height && alphaMode)
-			{
-				pixels[(y * width) + x] = blendPixel(pixels[(y * width) + x], rgb, a);
-			}
-			return;
-		}
-		uint32* getPixel(uint32 x, uint32 y)
-		{
-			if (x < width && y < height){return &pixels[(y * width) + x];
-			} else return nullptr;
-		}
-		uint32* accessPixel(uint32 x, uint32 y){return &pixels[(y * width) + x];
-		}
-		const uint32* getPixelData(void) const {return &pixels[0];
-		}
-
-		uint32 getWidth(void){return width;
-		}
-		uint32 getHeight(void){return height;
-		}
-
-		uint32 getConsoleWidth(void){return consoleWidth;
-		}
-		uint32 getConsoleHeight(void){return consoleHeight;
-		}
-
-		uint16 getPixelSize(void){return pixelSize;
-		}
-
-		//Pixelizes the output already drawn to the screen (this is a very costly function, only use when nessesary)
-		void pixelize(const float ratio)
-		{
-			if (!(ratio <= 1.f) && ratio < width && ratio < height)
-			{
-				pixels = ResizeDataNearestNeighbor(pixels, width / ratio, height / ratio);
-				pixels = ResizeDataNearestNeighbor(pixels, consoleWidth / pixelSize, consoleHeight / pixelSize);
-			}
-			return;
-		}
-
-		void lineHorizontal(uint32 x, uint32 y, uint32 iterations, uint32 rgb, bool forward = true)
-		{
-			if (x < width && y < height && ((forward && x + iterations < width) || (!forward && x - iterations < width)))
-			{
-				for (uint32 i = 0; i < iterations; ++i)
-				{
-					accessBuffer(forward ? x + i : x - i, y) = rgb;
-				}
-			}
-			else {
-				for (uint32 i = 0; i < iterations; ++i)
-				{
-					if (x + i < width){accessBuffer(forward ? x + i : x - i, y) = rgb;
-					}
-					else break;
-				}
-			}
-			return;
-		}
-
-		void lineVertical(uint32 x, uint32 y, uint32 iterations, uint32 rgb, bool forward = true)
-		{
-			if (x < width && y < height && ((forward && y + iterations < height) || (!forward && y - iterations < height)))
-			{
-				for (uint32 i = 0; i < iterations; ++i)
-				{
-					accessBuffer(x, forward ? y + i : y - i) = rgb;
-				}
-			}
-			else {
-				for (uint32 i = 0; i < iterations; ++i)
-				{
-					if (y + i < height){accessBuffer(x, forward ? y + i : y - i) = rgb;
-					} else break;
-				}
-			}
-			return;
-		}
-
-		void drawLine(uint32 x0, uint32 y0, uint32 x1, uint32 y1, uint32 rgb, uint8 alpha = 255)
-		{
-			int32 w, h, l;
-			float dx, dy;
-			uint32 x = x0, y = y0;
-
-			w = x1 - x0;
-			h = y1 - y0;
-			l = ceil(sqrtf((w * w) + (h * h)));
-			dx = (float)w / (float)l;
-			dy = (float)h / (float)l;
-
-			for (uint32 i = 0; i < l; ++i)
-			{
-				x = x0 + (dx * i);
-				y = y0 + (dy * i);
-				if (x < width && y < height)
-				{
-					switch (alpha)
-					{
-						case 255:
-							accessBuffer(x, y) = rgb;
-							break;
-
-						default:
-							accessBuffer(x, y) = blendPixel(accessBuffer(x, y), rgb, alpha);
-							break;
-					}
-				} else break;
-			}
-			return;
-		}
-
-		void drawRect(uint32 x, uint32 y, uint32 width, uint32 height, uint32 rgb, bool fill = true)
-		{
-			if (fill)
-			{
-				for (uint32 dy = y; dy < y + height; ++dy)
-				{
-					for (uint32 dx = x; dx < x + width; ++dx)
-					{
-						if (dx < this->width && dy < this->height)
-						{
-							pixels[(dy * this->width) + dx] = rgb;
-						}
-					}
-				}
-			}
-			else {
-				lineHorizontal(x, y, width, rgb);
-				lineVertical(x + width, y, height, rgb);
-				lineHorizontal(x + width, y + height, width, rgb, false);
-				lineVertical(x, y + height, height, rgb, false);
-			}
-			return;
-		}
-		void drawRectA(uint32 x, uint32 y, uint32 width, uint32 height, uint32 rgb, uint8 a)
-		{
-			for (uint32 dy = y; dy < y + height; ++dy)
-			{
-				for (uint32 dx = x; dx < x + width; ++dx)
-				{
-					if (dx < this->width && dy < this->height)
-					{
-						pixels[(dy * this->width) + dx] = blendPixel(pixels[(dy * this->width) + dx], rgb, a);
-					}
-				}
-			}
-			return;
-		}
-
-		//Enable Post-Processing shaders
-		void enablePPShaders(void)
-		{
-			enableShaders = true;
-			return;
-		}
-		//Disable Post-Processing shaders
-		void disablePPShaders(void)
-		{
-			enableShaders = false;
-			return;
-		}
-		//Load Post-Processing shaders for ConsoleGraphics to use
-		void loadPPShader(void(*funcPtr)(uint32*, uint32, uint32, uint32, uint32, void*), void* shaderData = nullptr)
-		{
-			shaderList.push_back(funcPtr);
-			shaderDataList.push_back(shaderData);
-			return;
-		}
-		//Clear all Post-Processing shaders
-		void clearPPShaders(void)
-		{
-			shaderList.clear();
-			shaderDataList.clear();
-			return;
-		}
-		//Draws image to a buffer
-		void draw(Image& image)
-		{
-			for (uint32 y = 0; y < image.getHeight(); ++y)
-			{
-				for (uint32 x = 0; x < image.getWidth(); ++x)
-				{
-					uint32 dstX = x + image.getPosX(), dstY = y + image.getPosY();
-					if (dstX < width && dstY < height) //Within bounds
-					{
-						if (image.getPixel(x, y)->second == 255 || !alphaMode) //Can't do alpha or alpha isn't enabled
-						{
-							pixels[(dstY * width) + dstX] = image.accessPixel(x, y)->first;
-						} else if (image.getPixel(x, y)->second != 0) { //Alpha is enabled
-							pixels[(dstY * width) + dstX] = blendPixel(pixels[(dstY * width) + dstX], image.accessPixel(x, y)->first, image.accessPixel(x, y)->second);
-						}
-					} else if (dstY > height - 1){return;
-					} else if (dstX > width - 1){break;
-					}
-				}
-			}
-			return;
-		}
-		void draw(Text& text)
-		{
-			this->draw(text.getTextImage());
-			return;
-		}
-		//drawType = DrawType::Repeat - if width > image.width() or height > image.height(), the image will be tiled
-		//drawType = DrawType::Resized - if width > image.width() or height > image.height(), the image will be resampled using nearest neighbor interpolation
-		//A more advanced version of the draw function
-		void drawEX(Image& image, uint32 srcX, uint32 srcY, uint32 dstX, uint32 dstY, uint32 width, uint32 height, DrawType drawType = DrawType::Repeat, void(*funcPtr)(std::pair<uint32, uint8>*, void*) = nullptr, void* funcData = nullptr)
-		{
-			uint32 x = srcX, y = srcY, dx = dstX, dy = dstY;
-
-			if (drawType == DrawType::Repeat)
-			{
-				while (dy < dstY + height && dy < this->height)
-				{
-					while (dx < dstX + width && dx < this->width)
-					{
-						if (dx < this->width && dy < this->height) //Within bounds
-						{
-							auto pixel = image.getPixelData()[(y * image.getWidth()) + x];
-							if (funcPtr != nullptr){funcPtr(&pixel, funcData);
-							}
-							if (pixel.second == 255 || !alphaMode) //Can't do alpha or alpha isn't enabled
-							{
-								pixels[(dy * this->width) + dx] = pixel.first;//image.getPixel(x, y)->first;
-							} else if (pixel.second != 0){ //Alpha is enabled
-								pixels[(dy * this->width) + dx] = blendPixel(pixels[(dy * this->width) + dx], pixel.first, pixel.second);
-							}
-						} else if (dy > this->height - 1){return;
-						} else if (dx > this->width - 1){break;
-						}
-						if (x == image.getWidth() - 1){x = 0;
-						}
-						else ++x;
-						++dx;
-					}
-					x = srcX;
-					dx = dstX;
-					if (y == image.getHeight() - 1){y = 0;
-					} else ++y;
-					++dy;
-				}
-			} else {
-				if (srcX >= image.getWidth()){srcX %= image.getWidth();
-				}
-				if (srcY >= image.getHeight()){srcY %= image.getHeight();
-				}
-				float scaleX = (float)(image.getWidth() - srcX) / (float)width, scaleY = (float)(image.getHeight() - srcY) / (float)height;
-
-				while (dy < dstY + height && dy < this->height)
-				{
-					while (dx < dstX + width && dx < this->width)
-					{
-						if (dx < this->width && dy < this->height) //Within bounds
-						{
-							x = srcX + ((dx - dstX) * scaleX);
-							x = std::max<int>(std::min<int>(x, image.getWidth()), 0);
-							y = srcY + ((dy - dstY) * scaleY);
-							y = std::max<int>(std::min<int>(y, image.getHeight()), 0);
-							auto pixel = image.getPixelData()[(y * image.getWidth()) + x];
-							if (funcPtr != nullptr){funcPtr(&pixel, funcData);
-							}
-							if (pixel.second == 255 || !alphaMode) //Can't do alpha or alpha isn't enabled
-							{
-								pixels[(dy * this->width) + dx] = pixel.first;//image.getPixel(x, y)->first;
-							} else if (pixel.second != 0){ //Alpha is enabled
-								pixels[(dy * this->width) + dx] = blendPixel(pixels[(dy * this->width) + dx], pixel.first, pixel.second);
-							}
-						} else if (dy > this->height - 1){return;
-						} else if (dx > this->width - 1){break;
-						}
-						++dx;
-					}
-					dx = dstX;
-					++dy;
-				}
-			}
-		}
-
-		void setTitle(const std::string title)
-		{
-			this->title = title;
-			SetConsoleTitleA(this->title.c_str());
-			return;
-		}
-		std::string getTitle(void){return title;
-		}
-
-		void setOutputScale(float s)
-		{
-			outputScale = s;
-			return;
-		}
-		float getOutputScale(void){return outputScale;
-		}
-
-		void setOutputPos(uint32 x, uint32 y)
-		{
-			startX = x;
-			startY = y;
-			return;
-		}
-		uint32 getOutputPosX(void){return startX;
-		}
-		uint32 getOutputPosY(void){return startY;
-		}
-
-		void setRenderTarget(HWND hwnd)
-		{
-			targetDC = GetDC(hwnd);
-			tempDC = CreateCompatibleDC(targetDC);
-			return;
-		}
-		void setRenderTarget(HDC hdc)
-		{
-			targetDC = hdc;
-			tempDC = CreateCompatibleDC(targetDC);
-			return;
-		}
-		HWND getRenderTarget(void){return WindowFromDC(targetDC);
-		}
-	};
-};
-
+//ConsoleGraphics V1.1
+//ISO C++ 11 or higher must be used to compile ConsoleGraphics.
+//Define CG_HEADLESS (or build on a non-Windows platform) to render into memory without windows.h.
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cctype>
+#include <limits>
+#include <cmath>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <utility>
+#include <cstring>
+#include <memory>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+#if defined(_WIN32) && !defined(CG_HEADLESS)
+	#define CG_WINDOWS
+	#define NOMINMAX
+	#include <windows.h>
+#endif
+
+//Define CG_NO_SIMD to only use the scalar code paths
+#if !defined(CG_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define CG_SSE2
+	#include <emmintrin.h>
+	//AVX2 versions are compiled separately and chosen at runtime
+	#if defined(__GNUC__)
+		#define CG_AVX2
+		#define CG_TARGET_AVX2 __attribute__((target("avx2")))
+		#include <immintrin.h>
+	#elif defined(_MSC_VER)
+		#define CG_AVX2
+		#define CG_TARGET_AVX2
+		#include <immintrin.h>
+		#include <intrin.h>
+	#endif
+#endif
+
+#ifdef CG_DEBUG
+	#include <iostream>
+	#include <cerrno>
+#endif
+
+#ifndef int8
+	#define int8 int8_t
+	#define uint8 uint8_t
+	#define int16 int16_t
+	#define uint16 uint16_t
+	#define int32 int32_t
+	#define uint32 uint32_t
+	#define int64 int64_t
+	#define uint64 uint64_t
+#endif
+
+#ifndef CG_INCLUDE
+#define CG_INCLUDE
+
+//cg::BGR() is the same as RGB() from windows.h
+#undef RGB
+
+namespace cg
+{
+	class ConsoleGraphics;
+
+	uint32 RGB(uint8 r, uint8 g, uint8 b){return r | (g << 8) | (b << 16);
+	}
+	uint32 BGR(uint8 r, uint8 g, uint8 b){return RGB(b, g, r);
+	}
+	uint32 RGBA(uint8 r, uint8 g, uint8 b, uint8 a){return RGB(r, g, b) | (a << 24);
+	}
+	uint32 RGBA(uint32 rgb, uint8 a){return (rgb & 0x00FFFFFF) | (a << 24);
+	}
+	uint32 BGRA(uint8 r, uint8 g, uint8 b, uint8 a){return RGBA(b, g, r, a);
+	}
+	uint32 BGRA(uint32 bgr, uint8 a){return (bgr & 0x00FFFFFF) | (a << 24);
+	}
+	
+	//If isRGB == false, then input is assumed to be in the BGRA format
+	uint8 GetR(uint32 rgba, bool isRGB = false){return isRGB ? rgba : rgba >> 16;
+	}
+	uint8 GetG(uint32 rgba){return rgba >> 8;
+	}
+	uint8 GetB(uint32 rgba, bool isRGB = false){return isRGB ? rgba >> 16 : rgba;
+	}
+	uint8 GetA(uint32 rgba){return rgba >> 24;
+	}
+
+	//Returns (dst * (255 - srcA) + src * srcA) / 255 for each channel, the top byte is 0
+	uint32 blendPixel(uint32 dstRGB, uint32 srcRGB, uint8 srcA)
+	{
+		//Red and blue are done together, each product fits in 16 bits
+		uint32 invA = 255 - srcA;
+		uint32 rb = ((dstRGB & 0x00FF00FF) * invA) + ((srcRGB & 0x00FF00FF) * srcA);
+		uint32 g = (((dstRGB >> 8) & 0xFF) * invA) + (((srcRGB >> 8) & 0xFF) * srcA);
+		//x / 255 == (x + 1 + (x >> 8)) >> 8 for 0 <= x <= 65280
+		rb = ((rb + 0x00010001 + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+		g = (g + 1 + (g >> 8)) >> 8;
+
+		return rb | (g << 8);
+	}
+	//Returns src + (dst * (255 - srcA)) / 255 for each channel (src is premultiplied), the top byte is 0
+	uint32 blendPixelPremultiplied(uint32 dstRGB, uint32 srcRGB, uint8 srcA)
+	{
+		uint32 invA = 255 - srcA;
+		uint32 rb = (dstRGB & 0x00FF00FF) * invA;
+		uint32 g = ((dstRGB >> 8) & 0xFF) * invA;
+		rb = ((rb + 0x00010001 + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+		g = (g + 1 + (g >> 8)) >> 8;
+
+		//Saturate in case the colour is larger than the alpha
+		uint32 r = std::min<uint32>((rb >> 16) + ((srcRGB >> 16) & 0xFF), 255);
+		g = std::min<uint32>(g + ((srcRGB >> 8) & 0xFF), 255);
+		uint32 b = std::min<uint32>((rb & 0xFF) + (srcRGB & 0xFF), 255);
+
+		return (r << 16) | (g << 8) | b;
+	}
+
+	//Packed 0xAARRGGBB pixel (4 bytes instead of 8 for std::pair<uint32, uint8>)
+	//"first" is the 0x00RRGGBB colour and "second" is the alpha, so code written for the old std::pair pixels still works
+	struct Pixel
+	{
+		uint32 first : 24;
+		uint32 second : 8;
+
+		Pixel() : first(0), second(0){}
+		Pixel(uint32 rgb, uint8 a) : first(rgb & 0x00FFFFFF), second(a){}
+		Pixel(const std::pair<uint32, uint8>& p) : first(p.first & 0x00FFFFFF), second(p.second){}
+
+		operator std::pair<uint32, uint8>() const {return std::make_pair((uint32)first, (uint8)second);
+		}
+
+		//Returns the pixel as 0xAARRGGBB
+		uint32 getARGB(void) const {return first | ((uint32)second << 24);
+		}
+		void setARGB(uint32 argb)
+		{
+			first = argb & 0x00FFFFFF;
+			second = argb >> 24;
+			return;
+		}
+	};
+	static_assert(sizeof(Pixel) == sizeof(uint32), "cg::Pixel must be packed into 32 bits");
+
+	//Vectorised alpha blending, every version gives the same result as blendPixel()
+	namespace blend
+	{
+		typedef void(*RowFunc)(uint32*, const Pixel*, uint32);
+		typedef void(*SpanFunc)(uint32*, uint32, uint8, uint32);
+		typedef void(*FillFunc)(uint32*, uint32, uint32);
+
+		void RowScalar(uint32* dst, const Pixel* src, uint32 count)
+		{
+			for (uint32 i = 0; i < count; ++i)
+			{
+				uint8 a = src[i].second;
+				if (a == 255){dst[i] = (dst[i] & 0xFF000000) | src[i].first;
+				}
+				else if (a != 0){dst[i] = (dst[i] & 0xFF000000) | blendPixel(dst[i], src[i].first, a);
+				}
+			}
+			return;
+		}
+		void FillScalar(uint32* dst, uint32 rgb, uint32 count)
+		{
+			for (uint32 i = 0; i < count; ++i)
+			{
+				dst[i] = rgb;
+			}
+			return;
+		}
+		void SpanScalar(uint32* dst, uint32 rgb, uint8 a, uint32 count)
+		{
+			for (uint32 i = 0; i < count; ++i)
+			{
+				dst[i] = (dst[i] & 0xFF000000) | blendPixel(dst[i], rgb, a);
+			}
+			return;
+		}
+		void RowPremultipliedScalar(uint32* dst, const Pixel* src, uint32 count)
+		{
+			for (uint32 i = 0; i < count; ++i)
+			{
+				uint8 a = src[i].second;
+				if (a == 255){dst[i] = (dst[i] & 0xFF000000) | src[i].first;
+				}
+				else if (a != 0 || src[i].first != 0){dst[i] = (dst[i] & 0xFF000000) | blendPixelPremultiplied(dst[i], src[i].first, a);
+				}
+			}
+			return;
+		}
+
+	#ifdef CG_SSE2
+		//Blends 16-bit channels, the alpha channel's weight is 0 so dst's top byte is kept
+		static inline __m128i Blend16(__m128i dst, __m128i src, __m128i a)
+		{
+			__m128i x = _mm_add_epi16(_mm_mullo_epi16(src, a), _mm_mullo_epi16(dst, _mm_sub_epi16(_mm_set1_epi16(255), a)));
+			return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+		}
+		//Copies each pixel's alpha to its three colour channels (as 16-bit words)
+		static inline __m128i SpreadAlpha16(__m128i p)
+		{
+			const __m128i colourMask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+			p = _mm_shufflehi_epi16(_mm_shufflelo_epi16(p, 0xFF), 0xFF);
+			return _mm_and_si128(p, colourMask);
+		}
+
+		void RowSSE2(uint32* dst, const Pixel* src, uint32 count)
+		{
+			const __m128i zero = _mm_setzero_si128(), alphaMask = _mm_set1_epi32(0xFF000000);
+			uint32 i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128i s = _mm_loadu_si128((const __m128i*)&src[i]);
+				__m128i alpha = _mm_and_si128(s, alphaMask);
+				uint32 opaque = _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alphaMask)), clear = _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero));
+				if (clear == 0xFFFF){continue;
+				}
+				__m128i d = _mm_loadu_si128((const __m128i*)&dst[i]);
+				if (opaque == 0xFFFF)
+				{
+					_mm_storeu_si128((__m128i*)&dst[i], _mm_or_si128(_mm_andnot_si128(alphaMask, s), _mm_and_si128(d, alphaMask)));
+					continue;
+				}
+				__m128i sLo = _mm_unpacklo_epi8(s, zero), sHi = _mm_unpackhi_epi8(s, zero);
+				__m128i lo = Blend16(_mm_unpacklo_epi8(d, zero), sLo, SpreadAlpha16(sLo));
+				__m128i hi = Blend16(_mm_unpackhi_epi8(d, zero), sHi, SpreadAlpha16(sHi));
+				_mm_storeu_si128((__m128i*)&dst[i], _mm_packus_epi16(lo, hi));
+			}
+			RowScalar(dst + i, src + i, count - i);
+			return;
+		}
+		void FillSSE2(uint32* dst, uint32 rgb, uint32 count)
+		{
+			const __m128i colour = _mm_set1_epi32(rgb);
+			uint32 i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				_mm_storeu_si128((__m128i*)&dst[i], colour);
+			}
+			FillScalar(dst + i, rgb, count - i);
+			return;
+		}
+		void SpanSSE2(uint32* dst, uint32 rgb, uint8 a, uint32 count)
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i alpha = _mm_set_epi16(0, a, a, a, 0, a, a, a);
+			const __m128i s = _mm_unpacklo_epi8(_mm_set1_epi32(rgb & 0x00FFFFFF), zero);
+			uint32 i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128i d = _mm_loadu_si128((const __m128i*)&dst[i]);
+				__m128i lo = Blend16(_mm_unpacklo_epi8(d, zero), s, alpha);
+				__m128i hi = Blend16(_mm_unpackhi_epi8(d, zero), s, alpha);
+				_mm_storeu_si128((__m128i*)&dst[i], _mm_packus_epi16(lo, hi));
+			}
+			SpanScalar(dst + i, rgb, a, count - i);
+			return;
+		}
+
+		//src + dst * (255 - a) / 255, src's alpha word must be 0 so dst's top byte is kept
+		static inline __m128i BlendPremultiplied16(__m128i dst, __m128i src, __m128i a)
+		{
+			__m128i x = _mm_mullo_epi16(dst, _mm_sub_epi16(_mm_set1_epi16(255), a));
+			return _mm_add_epi16(_mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8), src);
+		}
+		void RowPremultipliedSSE2(uint32* dst, const Pixel* src, uint32 count)
+		{
+			const __m128i zero = _mm_setzero_si128(), alphaMask = _mm_set1_epi32(0xFF000000);
+			uint32 i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128i s = _mm_loadu_si128((const __m128i*)&src[i]);
+				uint32 opaque = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, alphaMask), alphaMask)), clear = _mm_movemask_epi8(_mm_cmpeq_epi32(s, zero));
+				if (clear == 0xFFFF){continue;
+				}
+				__m128i d = _mm_loadu_si128((const __m128i*)&dst[i]);
+				__m128i colour = _mm_andnot_si128(alphaMask, s);
+				if (opaque == 0xFFFF)
+				{
+					_mm_storeu_si128((__m128i*)&dst[i], _mm_or_si128(colour, _mm_and_si128(d, alphaMask)));
+					continue;
+				}
+				__m128i lo = BlendPremultiplied16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(colour, zero), SpreadAlpha16(_mm_unpacklo_epi8(s, zero)));
+				__m128i hi = BlendPremultiplied16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(colour, zero), SpreadAlpha16(_mm_unpackhi_epi8(s, zero)));
+				_mm_storeu_si128((__m128i*)&dst[i], _mm_packus_epi16(lo, hi));
+			}
+			RowPremultipliedScalar(dst + i, src + i, count - i);
+			return;
+		}
+	#endif
+
+	#ifdef CG_AVX2
+		CG_TARGET_AVX2 static inline __m256i Blend16AVX2(__m256i dst, __m256i src, __m256i a)
+		{
+			__m256i x = _mm256_add_epi16(_mm256_mullo_epi16(src, a), _mm256_mullo_epi16(dst, _mm256_sub_epi16(_mm256_set1_epi16(255), a)));
+			return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, _mm256_set1_epi16(1)), _mm256_srli_epi16(x, 8)), 8);
+		}
+		CG_TARGET_AVX2 static inline __m256i SpreadAlpha16AVX2(__m256i p)
+		{
+			const __m256i colourMask = _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1);
+			p = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(p, 0xFF), 0xFF);
+			return _mm256_and_si256(p, colourMask);
+		}
+
+		//The AVX2 kernels clear the upper register halves before handing the tail to SSE2 code
+		//Compilers can turn that call into a jump that skips vzeroupper, and mixing the two is very slow on some CPUs
+		CG_TARGET_AVX2 void RowAVX2(uint32* dst, const Pixel* src, uint32 count)
+		{
+			const __m256i zero = _mm256_setzero_si256(), alphaMask = _mm256_set1_epi32(0xFF000000);
+			uint32 i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256i s = _mm256_loadu_si256((const __m256i*)&src[i]);
+				__m256i alpha = _mm256_and_si256(s, alphaMask);
+				uint32 opaque = _mm256_movemask_epi8(_mm256_cmpeq_epi32(alpha, alphaMask)), clear = _mm256_movemask_epi8(_mm256_cmpeq_epi32(alpha, zero));
+				if (clear == 0xFFFFFFFF){continue;
+				}
+				__m256i d = _mm256_loadu_si256((const __m256i*)&dst[i]);
+				if (opaque == 0xFFFFFFFF)
+				{
+					_mm256_storeu_si256((__m256i*)&dst[i], _mm256_or_si256(_mm256_andnot_si256(alphaMask, s), _mm256_and_si256(d, alphaMask)));
+					continue;
+				}
+				//Unpack and pack both work within 128-bit lanes so the pixel order is kept
+				__m256i sLo = _mm256_unpacklo_epi8(s, zero), sHi = _mm256_unpackhi_epi8(s, zero);
+				__m256i lo = Blend16AVX2(_mm256_unpacklo_epi8(d, zero), sLo, SpreadAlpha16AVX2(sLo));
+				__m256i hi = Blend16AVX2(_mm256_unpackhi_epi8(d, zero), sHi, SpreadAlpha16AVX2(sHi));
+				_mm256_storeu_si256((__m256i*)&dst[i], _mm256_packus_epi16(lo, hi));
+			}
+			_mm256_zeroupper();
+			RowSSE2(dst + i, src + i, count - i);
+			return;
+		}
+		CG_TARGET_AVX2 void FillAVX2(uint32* dst, uint32 rgb, uint32 count)
+		{
+			const __m256i colour = _mm256_set1_epi32(rgb);
+			uint32 i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				_mm256_storeu_si256((__m256i*)&dst[i], colour);
+			}
+			_mm256_zeroupper();
+			FillSSE2(dst + i, rgb, count - i);
+			return;
+		}
+		CG_TARGET_AVX2 void SpanAVX2(uint32* dst, uint32 rgb, uint8 a, uint32 count)
+		{
+			const __m256i zero = _mm256_setzero_si256();
+			const __m256i alpha = _mm256_set_epi16(0, a, a, a, 0, a, a, a, 0, a, a, a, 0, a, a, a);
+			const __m256i s = _mm256_unpacklo_epi8(_mm256_set1_epi32(rgb & 0x00FFFFFF), zero);
+			uint32 i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256i d = _mm256_loadu_si256((const __m256i*)&dst[i]);
+				__m256i lo = Blend16AVX2(_mm256_unpacklo_epi8(d, zero), s, alpha);
+				__m256i hi = Blend16AVX2(_mm256_unpackhi_epi8(d, zero), s, alpha);
+				_mm256_storeu_si256((__m256i*)&dst[i], _mm256_packus_epi16(lo, hi));
+			}
+			_mm256_zeroupper();
+			SpanSSE2(dst + i, rgb, a, count - i);
+			return;
+		}
+
+		CG_TARGET_AVX2 static inline __m256i BlendPremultiplied16AVX2(__m256i dst, __m256i src, __m256i a)
+		{
+			__m256i x = _mm256_mullo_epi16(dst, _mm256_sub_epi16(_mm256_set1_epi16(255), a));
+			return _mm256_add_epi16(_mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, _mm256_set1_epi16(1)), _mm256_srli_epi16(x, 8)), 8), src);
+		}
+		CG_TARGET_AVX2 void RowPremultipliedAVX2(uint32* dst, const Pixel* src, uint32 count)
+		{
+			const __m256i zero = _mm256_setzero_si256(), alphaMask = _mm256_set1_epi32(0xFF000000);
+			uint32 i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256i s = _mm256_loadu_si256((const __m256i*)&src[i]);
+				uint32 opaque = _mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(s, alphaMask), alphaMask)), clear = _mm256_movemask_epi8(_mm256_cmpeq_epi32(s, zero));
+				if (clear == 0xFFFFFFFF){continue;
+				}
+				__m256i d = _mm256_loadu_si256((const __m256i*)&dst[i]);
+				__m256i colour = _mm256_andnot_si256(alphaMask, s);
+				if (opaque == 0xFFFFFFFF)
+				{
+					_mm256_storeu_si256((__m256i*)&dst[i], _mm256_or_si256(colour, _mm256_and_si256(d, alphaMask)));
+					continue;
+				}
+				__m256i lo = BlendPremultiplied16AVX2(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(colour, zero), SpreadAlpha16AVX2(_mm256_unpacklo_epi8(s, zero)));
+				__m256i hi = BlendPremultiplied16AVX2(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(colour, zero), SpreadAlpha16AVX2(_mm256_unpackhi_epi8(s, zero)));
+				_mm256_storeu_si256((__m256i*)&dst[i], _mm256_packus_epi16(lo, hi));
+			}
+			_mm256_zeroupper();
+			RowPremultipliedSSE2(dst + i, src + i, count - i);
+			return;
+		}
+
+		bool HasAVX2(void)
+		{
+		#if defined(__GNUC__)
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2");
+		#else
+			int info[4];
+			__cpuid(info, 1);
+			bool osxsave = (info[2] & (1 << 27)) != 0, avx = (info[2] & (1 << 28)) != 0;
+			if (!osxsave || !avx || (_xgetbv(0) & 0x06) != 0x06){return false;
+			}
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+		#endif
+		}
+	#endif
+
+		//Set to false to force the scalar versions (e.g. for benchmarking)
+		bool& UseSIMD(void)
+		{
+			static bool useSIMD = true;
+			return useSIMD;
+		}
+
+		RowFunc GetRowFunc(void)
+		{
+		#ifdef CG_AVX2
+			static const bool avx2 = HasAVX2();
+			if (UseSIMD() && avx2){return RowAVX2;
+			}
+		#endif
+		#ifdef CG_SSE2
+			if (UseSIMD()){return RowSSE2;
+			}
+		#endif
+			return RowScalar;
+		}
+		SpanFunc GetSpanFunc(void)
+		{
+		#ifdef CG_AVX2
+			static const bool avx2 = HasAVX2();
+			if (UseSIMD() && avx2){return SpanAVX2;
+			}
+		#endif
+		#ifdef CG_SSE2
+			if (UseSIMD()){return SpanSSE2;
+			}
+		#endif
+			return SpanScalar;
+		}
+		FillFunc GetFillFunc(void)
+		{
+		#ifdef CG_AVX2
+			static const bool avx2 = HasAVX2();
+			if (UseSIMD() && avx2){return FillAVX2;
+			}
+		#endif
+		#ifdef CG_SSE2
+			if (UseSIMD()){return FillSSE2;
+			}
+		#endif
+			return FillScalar;
+		}
+		RowFunc GetPremultipliedRowFunc(void)
+		{
+		#ifdef CG_AVX2
+			static const bool avx2 = HasAVX2();
+			if (UseSIMD() && avx2){return RowPremultipliedAVX2;
+			}
+		#endif
+		#ifdef CG_SSE2
+			if (UseSIMD()){return RowPremultipliedSSE2;
+			}
+		#endif
+			return RowPremultipliedScalar;
+		}
+	};
+
+	//Blends a row of pixels over dst using each pixel's alpha, the top byte of dst is kept
+	void blendRow(uint32* dst, const Pixel* src, uint32 count)
+	{
+		blend::GetRowFunc()(dst, src, count);
+		return;
+	}
+	//Blends one colour over a row of pixels, the top byte of dst is kept
+	void blendSpan(uint32* dst, uint32 rgb, uint8 a, uint32 count)
+	{
+		blend::GetSpanFunc()(dst, rgb, a, count);
+		return;
+	}
+	//Sets a row of pixels to one colour
+	void fillSpan(uint32* dst, uint32 rgb, uint32 count)
+	{
+		blend::GetFillFunc()(dst, rgb, count);
+		return;
+	}
+	//Blends a row of pixels over a row of image pixels, dst's alpha is kept
+	void blendRow(Pixel* dst, const Pixel* src, uint32 count)
+	{
+		//Pixel is laid out as 0xAARRGGBB so the vector kernels can load it directly, the rest is done through Pixel
+		blend::RowFunc func = blend::GetRowFunc();
+		uint32 i = func == blend::RowScalar ? 0 : count & ~7u;
+		if (i != 0){func(reinterpret_cast<uint32*>(dst), src, i);
+		}
+		for (; i < count; ++i)
+		{
+			if (src[i].second == 255){dst[i].first = src[i].first;
+			}
+			else if (src[i].second != 0){dst[i].first = blendPixel(dst[i].first, src[i].first, src[i].second);
+			}
+		}
+		return;
+	}
+	//Blends a row of premultiplied pixels over dst (src + dst * (1 - a)), the top byte of dst is kept
+	void blendRowPremultiplied(uint32* dst, const Pixel* src, uint32 count)
+	{
+		blend::GetPremultipliedRowFunc()(dst, src, count);
+		return;
+	}
+	//Blends a row of premultiplied pixels over a row of image pixels, dst's alpha is kept
+	void blendRowPremultiplied(Pixel* dst, const Pixel* src, uint32 count)
+	{
+		blend::RowFunc func = blend::GetPremultipliedRowFunc();
+		uint32 i = func == blend::RowPremultipliedScalar ? 0 : count & ~7u;
+		if (i != 0){func(reinterpret_cast<uint32*>(dst), src, i);
+		}
+		for (; i < count; ++i)
+		{
+			if (src[i].second == 255){dst[i].first = src[i].first;
+			}
+			else if (src[i].second != 0 || src[i].first != 0){dst[i].first = blendPixelPremultiplied(dst[i].first, src[i].first, src[i].second);
+			}
+		}
+		return;
+	}
+
+	//Nearest neighbour scaling driven by per-axis source index tables
+	namespace nearest
+	{
+		typedef void(*GatherFunc)(uint32*, const uint32*, const uint32*, uint32);
+
+		template<typename T> void Gather(T* dst, const T* src, const uint32* index, uint32 count)
+		{
+			uint32 i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				dst[i] = src[index[i]];
+				dst[i + 1] = src[index[i + 1]];
+				dst[i + 2] = src[index[i + 2]];
+				dst[i + 3] = src[index[i + 3]];
+			}
+			for (; i < count; ++i)
+			{
+				dst[i] = src[index[i]];
+			}
+			return;
+		}
+
+	#ifdef CG_AVX2
+		CG_TARGET_AVX2 void GatherAVX2(uint32* dst, const uint32* src, const uint32* index, uint32 count)
+		{
+			uint32 i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256i idx = _mm256_loadu_si256((const __m256i*)&index[i]);
+				_mm256_storeu_si256((__m256i*)&dst[i], _mm256_i32gather_epi32((const int*)src, idx, 4));
+			}
+			_mm256_zeroupper();
+			Gather(dst + i, src, index + i, count - i);
+			return;
+		}
+	#endif
+
+		//Returns nullptr if there's no vector version
+		GatherFunc GetGatherFunc(void)
+		{
+		#ifdef CG_AVX2
+			static const bool avx2 = blend::HasAVX2();
+			if (blend::UseSIMD() && avx2){return GatherAVX2;
+			}
+		#endif
+			return nullptr;
+		}
+	};
+
+	//Fills table with min(offset + (first + i) * scale, limit) for each destination index (same rounding as the old per-pixel float maths)
+	//first skips destination indices, e.g. the columns of a draw that are clipped off the left edge
+	void buildIndexTable(std::vector<uint32>& table, uint32 count, float scale, uint32 offset = 0, uint32 limit = 0xFFFFFFFF, uint32 first = 0)
+	{
+		table.resize(count);
+		for (uint32 i = 0; i < count; ++i)
+		{
+			table[i] = std::min<uint32>(offset + ((first + i) * scale), limit);
+		}
+		return;
+	}
+	//Copies src[index[i]] to dst[i] for each pixel
+	template<typename T> void gatherNearest(T* dst, const T* src, const uint32* index, uint32 count)
+	{
+		static_assert(sizeof(T) == sizeof(uint32), "cg::gatherNearest() works on 32 bit pixels");
+		nearest::GatherFunc gather = nearest::GetGatherFunc();
+		if (gather != nullptr){gather(reinterpret_cast<uint32*>(dst), reinterpret_cast<const uint32*>(src), index, count);
+		} else nearest::Gather(dst, src, index, count);
+		return;
+	}
+	//Copies src[xTable[x]] of row yTable[y] to each destination pixel, rows that use the same source row as the one above are copied with memcpy
+	template<typename T> void scaleNearest(T* dst, uint32 dstWidth, uint32 dstHeight, const T* src, uint32 srcWidth, const uint32* xTable, const uint32* yTable)
+	{
+		for (uint32 y = 0; y < dstHeight; ++y)
+		{
+			T* row = dst + (y * dstWidth);
+			if (y != 0 && yTable[y] == yTable[y - 1]){memcpy(row, row - dstWidth, dstWidth * sizeof(T));
+			} else gatherNearest(row, src + (yTable[y] * srcWidth), xTable, dstWidth);
+		}
+		return;
+	}
+
+	//How Image operations run, Sequential on the calling thread, Parallel split across ThreadPool::getShared()
+	enum class ExecutionPolicy {Sequential, Parallel};
+
+	//Pool of worker threads used to split loops across cores
+	//Each thread of a parallelFor() starts with an even share of the loop and takes chunks from the front of it,
+	//a thread that runs out steals the back half of the largest share left, so uneven chunks balance out without a shared counter
+	class ThreadPool
+	{
+		//Unclaimed part of one thread's share, begin is in the low 32 bits and end in the high 32 bits
+		struct Share
+		{
+			std::atomic<uint64> range;
+			char padding[64 - sizeof(std::atomic<uint64>)]; //Each share gets its own cache line
+		};
+		std::vector<std::thread> workers;
+		std::vector<Share> shares;
+		std::mutex mutex, jobMutex;
+		std::condition_variable wake, finished;
+		const std::function<void(uint32, uint32)>* job = nullptr;
+		uint32 jobGrain = 1, jobThreads = 0;
+		uint32 activeWorkers = 0;
+		uint64 generation = 0;
+		bool stop = false;
+
+		static bool& InsideWorker(void)
+		{
+			static thread_local bool insideWorker = false;
+			return insideWorker;
+		}
+		static uint64 PackRange(uint32 begin, uint32 end)
+		{
+			return (uint64)begin | ((uint64)end << 32);
+		}
+
+		//Takes up to jobGrain items from the front of a share
+		bool TakeFront(Share& share, uint32& begin, uint32& end)
+		{
+			uint64 range = share.range.load();
+			while (true)
+			{
+				begin = (uint32)range, end = (uint32)(range >> 32);
+				if (begin >= end){return false;
+				}
+				const uint32 next = end - begin > jobGrain ? begin + jobGrain : end;
+				if (share.range.compare_exchange_weak(range, PackRange(next, end)))
+				{
+					end = next;
+					return true;
+				}
+			}
+		}
+		//Moves the back half of the largest other share into share "self", false once every share is empty
+		bool Steal(uint32 self)
+		{
+			while (true)
+			{
+				uint32 victim = self, largest = 0;
+				uint64 range = 0;
+				for (uint32 i = 0; i < jobThreads; ++i)
+				{
+					const uint64 r = shares[i].range.load();
+					const uint32 begin = (uint32)r, end = (uint32)(r >> 32);
+					if (i != self && end > begin && end - begin > largest)
+					{
+						victim = i, largest = end - begin, range = r;
+					}
+				}
+				if (largest == 0){return false;
+				}
+				//A single item is taken whole
+				const uint32 begin = (uint32)range, end = (uint32)(range >> 32), middle = begin + (largest / 2);
+				if (shares[victim].range.compare_exchange_strong(range, PackRange(begin, middle)))
+				{
+					shares[self].range.store(PackRange(middle, end));
+					return true;
+				}
+			}
+		}
+		//Runs chunks of the current job until there are none left to take or steal
+		void RunChunks(uint32 self)
+		{
+			uint32 begin, end;
+			do {
+				while (TakeFront(shares[self], begin, end))
+				{
+					(*job)(begin, end);
+				}
+			} while (Steal(self));
+			return;
+		}
+
+		void WorkerLoop(uint32 index)
+		{
+			InsideWorker() = true;
+			uint64 seenGeneration = 0;
+			std::unique_lock<std::mutex> lock(mutex);
+			while (true)
+			{
+				wake.wait(lock, [&]{return stop || generation != seenGeneration;});
+				if (stop){return;
+				}
+				seenGeneration = generation;
+				//Small jobs only use some of the threads
+				if (index >= jobThreads){continue;
+				}
+				lock.unlock();
+				RunChunks(index);
+				lock.lock();
+				if (--activeWorkers == 0){finished.notify_one();
+				}
+			}
+		}
+		void StartWorkers(uint32 threadCount)
+		{
+			if (threadCount == 0){threadCount = std::max<uint32>(std::thread::hardware_concurrency(), 1);
+			}
+			{
+				//New workers start at generation 0, so nothing from the last job may be left for them to pick up
+				std::lock_guard<std::mutex> lock(mutex);
+				stop = false;
+				job = nullptr;
+				jobThreads = 0;
+				activeWorkers = 0;
+				generation = 0;
+			}
+			shares = std::vector<Share>(threadCount);
+			for (uint32 i = 1; i < threadCount; ++i)
+			{
+				workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+			}
+			return;
+		}
+		void StopWorkers(void)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stop = true;
+			}
+			wake.notify_all();
+			for (uint32 i = 0; i < workers.size(); ++i)
+			{
+				workers[i].join();
+			}
+			workers.clear();
+			return;
+		}
+
+	public:
+		//threadCount = 0 uses one thread per core (the calling thread counts as one)
+		ThreadPool(uint32 threadCount = 0)
+		{
+			StartWorkers(threadCount);
+		}
+		~ThreadPool()
+		{
+			StopWorkers();
+		}
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		//Returns the pool shared by ConsoleGraphics and Image
+		static ThreadPool& getShared(void)
+		{
+			static ThreadPool pool;
+			return pool;
+		}
+
+		uint32 getThreadCount(void) const {return workers.size() + 1;
+		}
+		//Restarts the pool with threadCount threads (0 = one per core, 1 = everything runs on the calling thread)
+		//Waits for the running parallelFor() to finish, so it mustn't be called from inside one
+		void setThreadCount(uint32 threadCount)
+		{
+			std::lock_guard<std::mutex> jobLock(jobMutex);
+			StopWorkers();
+			StartWorkers(threadCount);
+			return;
+		}
+
+		//Chunk size for a loop whose items each cost about itemCost (e.g. the pixels in a row)
+		//Chunks hold at least 16384 units of work, so small loops run on the calling thread without waking the pool
+		static uint32 chunkSize(uint32 itemCost)
+		{
+			return std::max<uint32>(16384 / std::max<uint32>(itemCost, 1), 1);
+		}
+
+		//Calls func(begin, end) over [0, count) in chunks of at most "grain" and waits until every chunk is done
+		//Only as many threads as there are chunks take part, chunks can run in any order
+		//Runs on the calling thread if the pool is busy, or if it's called from inside another parallelFor()
+		void parallelFor(uint32 count, uint32 grain, const std::function<void(uint32, uint32)>& func)
+		{
+			grain = std::max<uint32>(grain, 1);
+			std::unique_lock<std::mutex> jobLock(jobMutex, std::defer_lock);
+			if (count <= grain || workers.empty() || InsideWorker() || !jobLock.try_lock())
+			{
+				for (uint32 begin = 0; begin < count; begin += grain)
+				{
+					func(begin, std::min(begin + grain, count));
+				}
+				return;
+			}
+
+			const uint32 threads = std::min<uint64>(workers.size() + 1, ((uint64)count + grain - 1) / grain);
+			for (uint32 i = 0; i < threads; ++i)
+			{
+				shares[i].range.store(PackRange(((uint64)count * i) / threads, ((uint64)count * (i + 1)) / threads));
+			}
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				job = &func;
+				jobGrain = grain;
+				jobThreads = threads;
+				activeWorkers = threads - 1;
+				++generation;
+			}
+			wake.notify_all();
+
+			InsideWorker() = true;
+			RunChunks(0);
+			InsideWorker() = false;
+
+			std::unique_lock<std::mutex> lock(mutex);
+			finished.wait(lock, [&]{return activeWorkers == 0;});
+			job = nullptr;
+			return;
+		}
+		//parallelFor() if policy is Parallel, otherwise func(0, count) on the calling thread
+		void run(ExecutionPolicy policy, uint32 count, uint32 grain, const std::function<void(uint32, uint32)>& func)
+		{
+			if (policy == ExecutionPolicy::Parallel){parallelFor(count, grain, func);
+			}
+			else if (count != 0){func(0, count);
+			}
+			return;
+		}
+	};
+
+	//Bicubic is the same as CatmullRom
+	enum class InterpolationMethod {None, NearestNeighbor, Bilinear, Bicubic, Bisinusoidal, AreaAveraging, CatmullRom, Mitchell, Lanczos3};
+	enum class ExtrapolationMethod {None, Repeat, Extend};
+
+	enum class FilterType {Grayscale, WeightedGrayscale, Invert, Custom = 255};
+
+	//Terminal modes are output by cg::TerminalBackend
+	enum class RenderMode {BitBlt, BitBltInv, SetPixel, SetPixelVer, SetPixelInv, SetPixelVerInv, TerminalHalfBlock, TerminalBraille, TerminalQuadrant};
+	enum class DrawType {Repeat, Resize};
+	//How ConsoleGraphics::flushCommands() orders recorded draw calls
+	//Layer keeps the recorded order inside a layer
+	//LayerImage also groups draws of the same image inside each run of image draws, other commands (rects, lines, clear(), ...) stay where they were
+	//Images in a run are drawn in the order of their first draw, so overlapping draws of different images can change order
+	enum class CommandSort {None, Layer, LayerImage};
+
+	class Image
+	{
+		//First element in pair is for rgb data, the second is for alpha
+		std::vector<Pixel> pixels;
+		uint32 width, height;
+		int32 x = 0, y = 0;
+		float aspectRatio;
+		bool premultiplied = false;
+		//Mip level i + 1 is stored in mipLevels[i], built when first needed if mipmaps are enabled
+		bool mipmaps = false;
+		std::vector<std::unique_ptr<Image>> mipLevels;
+		//Summary of the alpha values, worked out when first needed and kept until the image changes
+		enum AlphaFlags : uint8 {AlphaKnown = 1, AlphaOpaque = 2, AlphaClear = 4};
+		mutable uint8 alphaFlags = 0;
+
+	protected:
+		//Source pixels and weight of the upper one for a destination pixel
+		struct BilinearTap
+		{
+			uint32 lower, upper;
+			float weight;
+		};
+		//Works out the taps the same way samplePixel() does with ExtrapolationMethod::Extend
+		static void BuildBilinearTaps(std::vector<BilinearTap>& taps, uint32 srcSize, uint32 dstSize)
+		{
+			float scale = (float)srcSize / (float)dstSize;
+			taps.resize(dstSize);
+			for (uint32 i = 0; i < dstSize; ++i)
+			{
+				float pos = i * scale;
+				pos /= srcSize;
+				pos = std::min(std::max(0.f, pos), 1.f) * (srcSize - 1);
+				taps[i].lower = pos;
+				taps[i].upper = std::min<uint32>(taps[i].lower + 1, srcSize - 1);
+				taps[i].weight = pos - std::floor(pos);
+			}
+			return;
+		}
+		//Lerps count bytes of two rows, rounding the same way samplePixel() does
+		static void LerpBytes(uint8* dst, const uint8* a, const uint8* b, float weight, uint32 count)
+		{
+			uint32 i = 0;
+		#ifdef CG_SSE2
+			//Same float operations as the scalar version, 16 bytes at a time
+			if (blend::UseSIMD())
+			{
+				const __m128i zero = _mm_setzero_si128();
+				const __m128 w = _mm_set1_ps(weight);
+				for (; i + 16 <= count; i += 16)
+				{
+					__m128i va = _mm_loadu_si128((const __m128i*)&a[i]), vb = _mm_loadu_si128((const __m128i*)&b[i]);
+					__m128i a16[2] = {_mm_unpacklo_epi8(va, zero), _mm_unpackhi_epi8(va, zero)};
+					__m128i d16[2] = {_mm_sub_epi16(_mm_unpacklo_epi8(vb, zero), a16[0]), _mm_sub_epi16(_mm_unpackhi_epi8(vb, zero), a16[1])};
+					__m128i out16[2];
+					for (uint32 h = 0; h < 2; ++h)
+					{
+						//Sign extend the differences to 32 bits
+						__m128i dLo = _mm_srai_epi32(_mm_unpacklo_epi16(d16[h], d16[h]), 16), dHi = _mm_srai_epi32(_mm_unpackhi_epi16(d16[h], d16[h]), 16);
+						__m128 lo = _mm_add_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(a16[h], zero)), _mm_mul_ps(w, _mm_cvtepi32_ps(dLo)));
+						__m128 hi = _mm_add_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(a16[h], zero)), _mm_mul_ps(w, _mm_cvtepi32_ps(dHi)));
+						out16[h] = _mm_packs_epi32(_mm_cvttps_epi32(lo), _mm_cvttps_epi32(hi));
+					}
+					_mm_storeu_si128((__m128i*)&dst[i], _mm_packus_epi16(out16[0], out16[1]));
+				}
+			}
+		#endif
+			for (; i < count; ++i)
+			{
+				dst[i] = a[i] + (weight * (int16)(b[i] - a[i]));
+			}
+			return;
+		}
+		//Resamples one source row horizontally into 4 bytes per pixel (b, g, r, a)
+		static void BilinearRow(uint8* dst, const Pixel* src, const std::vector<BilinearTap>& taps)
+		{
+			uint32 x = 0;
+		#ifdef CG_SSE2
+			//One pixel (4 channels) at a time
+			if (blend::UseSIMD())
+			{
+				const __m128i zero = _mm_setzero_si128();
+				for (; x < taps.size(); ++x)
+				{
+					__m128i v0 = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(src[taps[x].lower].getARGB()), zero), zero);
+					__m128i v1 = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(src[taps[x].upper].getARGB()), zero), zero);
+					__m128 out = _mm_add_ps(_mm_cvtepi32_ps(v0), _mm_mul_ps(_mm_set1_ps(taps[x].weight), _mm_cvtepi32_ps(_mm_sub_epi32(v1, v0))));
+					__m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(out), zero);
+					uint32 argb = _mm_cvtsi128_si32(_mm_packus_epi16(packed, zero));
+					memcpy(&dst[x * 4], &argb, sizeof(uint32));
+				}
+			}
+		#endif
+			for (; x < taps.size(); ++x)
+			{
+				uint32 p0 = src[taps[x].lower].getARGB(), p1 = src[taps[x].upper].getARGB();
+				for (uint32 c = 0; c < 4; ++c)
+				{
+					uint8 v0 = p0 >> (c * 8), v1 = p1 >> (c * 8);
+					dst[(x * 4) + c] = v0 + (taps[x].weight * (int16)(v1 - v0));
+				}
+			}
+			return;
+		}
+
+		//Separable bilinear resize, a horizontal pass into byte rows followed by a vertical pass over whole rows
+		//Each band of output rows keeps the last two horizontal rows, so each source row is usually only resampled once
+		void ResizeBilinear(const std::vector<Pixel>& pixels, std::vector<Pixel>& data, uint32 newWidth, uint32 newHeight, ExecutionPolicy policy)
+		{
+			std::vector<BilinearTap> xTaps, yTaps;
+			BuildBilinearTaps(xTaps, width, newWidth);
+			BuildBilinearTaps(yTaps, height, newHeight);
+			const uint32 rowSize = newWidth * 4;
+
+			ThreadPool::getShared().run(policy, newHeight, std::max<uint32>(65536 / std::max<uint32>(newWidth, 1), 1), [&](uint32 begin, uint32 end)
+			{
+				std::vector<uint8> upperRow(rowSize), lowerRow(rowSize), out(rowSize);
+				uint32 lowerIndex = 0xFFFFFFFF, upperIndex = 0xFFFFFFFF;
+				for (uint32 y = begin; y < end; ++y)
+				{
+					const BilinearTap& tap = yTaps[y];
+					if (tap.lower != lowerIndex)
+					{
+						if (tap.lower == upperIndex){lowerRow.swap(upperRow), upperIndex = 0xFFFFFFFF;
+						} else BilinearRow(lowerRow.data(), &pixels[tap.lower * width], xTaps);
+						lowerIndex = tap.lower;
+					}
+					if (tap.upper != upperIndex && tap.upper != lowerIndex)
+					{
+						BilinearRow(upperRow.data(), &pixels[tap.upper * width], xTaps);
+						upperIndex = tap.upper;
+					}
+
+					LerpBytes(out.data(), lowerRow.data(), tap.upper == lowerIndex ? lowerRow.data() : upperRow.data(), tap.weight, rowSize);
+
+					Pixel* dst = &data[y * newWidth];
+					for (uint32 x = 0; x < newWidth; ++x)
+					{
+						const uint8* p = &out[x * 4];
+						dst[x] = Pixel(cg::BGR(p[2], p[1], p[0]), p[3]);
+					}
+				}
+			});
+			return;
+		}
+
+		//Separable filter kernels, x is the distance from the sample in source pixels
+		static float FilterRadius(InterpolationMethod m)
+		{
+			return m == InterpolationMethod::Lanczos3 ? 3.f : 2.f;
+		}
+		static float FilterKernel(InterpolationMethod m, float x)
+		{
+			x = std::abs(x);
+			if (m == InterpolationMethod::Lanczos3)
+			{
+				if (x < 1e-6f){return 1.f;
+				}
+				if (x >= 3.f){return 0.f;
+				}
+				const float pi = 3.14159265f;
+				return (3.f * std::sin(pi * x) * std::sin((pi * x) / 3.f)) / (pi * pi * x * x);
+			}
+
+			//Mitchell-Netravali cubic, B = 0 and C = 0.5 is Catmull-Rom
+			const float b = (m == InterpolationMethod::Mitchell ? 1.f / 3.f : 0.f), c = (m == InterpolationMethod::Mitchell ? 1.f / 3.f : 0.5f);
+			if (x < 1.f){return ((((12.f - (9.f * b) - (6.f * c)) * x * x * x) + ((-18.f + (12.f * b) + (6.f * c)) * x * x) + (6.f - (2.f * b))) / 6.f);
+			}
+			if (x < 2.f){return ((((-b - (6.f * c)) * x * x * x) + (((6.f * b) + (30.f * c)) * x * x) + (((-12.f * b) - (48.f * c)) * x) + ((8.f * b) + (24.f * c))) / 6.f);
+			}
+			return 0.f;
+		}
+
+		//Source indices and 14 bit fixed point weights for each destination pixel of one axis
+		//taps is always even so the SIMD versions can do two taps at a time (padding taps have a weight of 0)
+		struct ConvolutionTable
+		{
+			uint32 taps;
+			std::vector<uint32> index;
+			std::vector<int16> weights;
+		};
+		static void BuildConvolutionTable(ConvolutionTable& table, uint32 srcSize, uint32 dstSize, InterpolationMethod m)
+		{
+			//When downscaling the kernel is stretched so every source pixel contributes
+			const float scale = (float)srcSize / (float)dstSize, filterScale = std::max(scale, 1.f);
+			const float support = FilterRadius(m) * filterScale;
+			table.taps = (uint32)std::ceil(support * 2.f);
+			table.taps += table.taps & 1;
+			table.index.assign(dstSize * table.taps, 0);
+			table.weights.assign(dstSize * table.taps, 0);
+
+			std::vector<float> w(table.taps);
+			for (uint32 i = 0; i < dstSize; ++i)
+			{
+				float centre = ((i + 0.5f) * scale) - 0.5f;
+				int32 first = (int32)std::floor(centre - support) + 1;
+				float total = 0.f;
+				for (uint32 t = 0; t < table.taps; ++t)
+				{
+					w[t] = FilterKernel(m, ((first + (int32)t) - centre) / filterScale);
+					total += w[t];
+				}
+
+				//Normalise so the weights add up to exactly 1 << 14, any rounding error goes to the largest weight
+				int32 sum = 0;
+				uint32 largest = 0;
+				for (uint32 t = 0; t < table.taps; ++t)
+				{
+					int32 v = (int32)std::floor(((w[t] / total) * 16384.f) + 0.5f);
+					table.weights[(i * table.taps) + t] = v;
+					table.index[(i * table.taps) + t] = std::min<int32>(std::max<int32>(first + (int32)t, 0), srcSize - 1);
+					sum += v;
+					if (std::abs(w[t]) > std::abs(w[largest])){largest = t;
+					}
+				}
+				table.weights[(i * table.taps) + largest] += 16384 - sum;
+			}
+			return;
+		}
+
+		//Clamps (x + rounding) >> 14 to a byte
+		static uint8 ConvolutionResult(int32 x)
+		{
+			return std::min<int32>(std::max<int32>((x + 8192) >> 14, 0), 255);
+		}
+		//Convolves a source row horizontally into 4 bytes per pixel (b, g, r, a)
+		static void ConvolveRow(uint8* dst, const Pixel* src, const ConvolutionTable& table, uint32 count)
+		{
+			uint32 x = 0;
+		#ifdef CG_SSE2
+			if (blend::UseSIMD())
+			{
+				//Interleaves the channels of two taps so _mm_madd_epi16 does both at once
+				const __m128i zero = _mm_setzero_si128(), round = _mm_set1_epi32(8192);
+				for (; x < count; ++x)
+				{
+					const uint32* index = &table.index[x * table.taps];
+					const int16* weights = &table.weights[x * table.taps];
+					__m128i sum = round;
+					for (uint32 t = 0; t < table.taps; t += 2)
+					{
+						__m128i p0 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(src[index[t]].getARGB()), zero);
+						__m128i p1 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(src[index[t + 1]].getARGB()), zero);
+						__m128i w = _mm_set1_epi32((uint16)weights[t] | ((uint32)(uint16)weights[t + 1] << 16));
+						sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi16(p0, p1), w));
+					}
+					__m128i packed = _mm_packs_epi32(_mm_srai_epi32(sum, 14), zero);
+					uint32 argb = _mm_cvtsi128_si32(_mm_packus_epi16(packed, zero));
+					memcpy(&dst[x * 4], &argb, sizeof(uint32));
+				}
+			}
+		#endif
+			for (; x < count; ++x)
+			{
+				int32 sum[4] = {0, 0, 0, 0};
+				for (uint32 t = 0; t < table.taps; ++t)
+				{
+					uint32 p = src[table.index[(x * table.taps) + t]].getARGB();
+					int32 w = table.weights[(x * table.taps) + t];
+					for (uint32 c = 0; c < 4; ++c)
+					{
+						sum[c] += (int32)((p >> (c * 8)) & 0xFF) * w;
+					}
+				}
+				for (uint32 c = 0; c < 4; ++c)
+				{
+					dst[(x * 4) + c] = ConvolutionResult(sum[c]);
+				}
+			}
+			return;
+		}
+		//Convolves rows vertically, rows[i] is the first byte of the row used by tap i
+		static void ConvolveColumn(uint8* dst, const uint8* const* rows, const int16* weights, uint32 taps, uint32 count)
+		{
+			uint32 i = 0;
+		#ifdef CG_SSE2
+			if (blend::UseSIMD())
+			{
+				const __m128i zero = _mm_setzero_si128(), round = _mm_set1_epi32(8192);
+				for (; i + 16 <= count; i += 16)
+				{
+					__m128i sum[4] = {round, round, round, round};
+					for (uint32 t = 0; t < taps; t += 2)
+					{
+						__m128i r0 = _mm_loadu_si128((const __m128i*)&rows[t][i]), r1 = _mm_loadu_si128((const __m128i*)&rows[t + 1][i]);
+						__m128i lo0 = _mm_unpacklo_epi8(r0, zero), hi0 = _mm_unpackhi_epi8(r0, zero);
+						__m128i lo1 = _mm_unpacklo_epi8(r1, zero), hi1 = _mm_unpackhi_epi8(r1, zero);
+						__m128i w = _mm_set1_epi32((uint16)weights[t] | ((uint32)(uint16)weights[t + 1] << 16));
+						sum[0] = _mm_add_epi32(sum[0], _mm_madd_epi16(_mm_unpacklo_epi16(lo0, lo1), w));
+						sum[1] = _mm_add_epi32(sum[1], _mm_madd_epi16(_mm_unpackhi_epi16(lo0, lo1), w));
+						sum[2] = _mm_add_epi32(sum[2], _mm_madd_epi16(_mm_unpacklo_epi16(hi0, hi1), w));
+						sum[3] = _mm_add_epi32(sum[3], _mm_madd_epi16(_mm_unpackhi_epi16(hi0, hi1), w));
+					}
+					__m128i lo = _mm_packs_epi32(_mm_srai_epi32(sum[0], 14), _mm_srai_epi32(sum[1], 14));
+					__m128i hi = _mm_packs_epi32(_mm_srai_epi32(sum[2], 14), _mm_srai_epi32(sum[3], 14));
+					_mm_storeu_si128((__m128i*)&dst[i], _mm_packus_epi16(lo, hi));
+				}
+			}
+		#endif
+			for (; i < count; ++i)
+			{
+				int32 sum = 0;
+				for (uint32 t = 0; t < taps; ++t)
+				{
+					sum += rows[t][i] * weights[t];
+				}
+				dst[i] = ConvolutionResult(sum);
+			}
+			return;
+		}
+
+		//Separable convolution resize (Catmull-Rom, Mitchell or Lanczos-3), the weights are worked out once per axis
+		//A horizontal pass into byte rows is followed by a vertical pass, both are split into bands on the shared thread pool
+		void ResizeConvolution(const std::vector<Pixel>& pixels, std::vector<Pixel>& data, uint32 newWidth, uint32 newHeight, InterpolationMethod m, ExecutionPolicy policy)
+		{
+			ConvolutionTable xTable, yTable;
+			BuildConvolutionTable(xTable, width, newWidth, m);
+			BuildConvolutionTable(yTable, height, newHeight, m);
+			const uint32 rowSize = newWidth * 4;
+			std::vector<uint8> rows(height * rowSize);
+			ThreadPool& pool = ThreadPool::getShared();
+
+			pool.run(policy, height, ThreadPool::chunkSize(newWidth * xTable.taps), [&](uint32 begin, uint32 end)
+			{
+				for (uint32 y = begin; y < end; ++y)
+				{
+					ConvolveRow(&rows[y * rowSize], &pixels[y * width], xTable, newWidth);
+				}
+			});
+
+			pool.run(policy, newHeight, ThreadPool::chunkSize(newWidth * yTable.taps), [&](uint32 begin, uint32 end)
+			{
+				std::vector<const uint8*> rowPtrs(yTable.taps);
+				std::vector<uint8> out(rowSize);
+				for (uint32 y = begin; y < end; ++y)
+				{
+					for (uint32 t = 0; t < yTable.taps; ++t)
+					{
+						rowPtrs[t] = &rows[yTable.index[(y * yTable.taps) + t] * rowSize];
+					}
+					ConvolveColumn(out.data(), rowPtrs.data(), &yTable.weights[y * yTable.taps], yTable.taps, rowSize);
+
+					Pixel* dst = &data[y * newWidth];
+					for (uint32 x = 0; x < newWidth; ++x)
+					{
+						const uint8* p = &out[x * 4];
+						dst[x] = Pixel(cg::BGR(p[2], p[1], p[0]), p[3]);
+					}
+				}
+			});
+			return;
+		}
+
+		//Source pixels covered by a destination pixel, in 16.16 fixed point source pixels
+		//The first and last pixels can be partly covered, the ones in between have a weight of 1 << 16
+		struct AreaSpan
+		{
+			uint32 first, last, firstWeight, lastWeight;
+			uint64 length; //Source sizes of 65536 or more don't fit in 16.16 fixed point
+			double reciprocal;
+		};
+		static void BuildAreaSpans(std::vector<AreaSpan>& spans, uint32 srcSize, uint32 dstSize)
+		{
+			spans.resize(dstSize);
+			for (uint32 i = 0; i < dstSize; ++i)
+			{
+				uint64 a = ((uint64)i * srcSize * 65536) / dstSize, b = ((uint64)(i + 1) * srcSize * 65536) / dstSize;
+				AreaSpan& span = spans[i];
+				span.first = a >> 16;
+				span.last = (b - 1) >> 16;
+				span.length = b - a;
+				span.reciprocal = 1.0 / span.length;
+				if (span.first == span.last){span.firstWeight = span.length, span.lastWeight = span.length;
+				}
+				else {
+					span.firstWeight = ((uint64)(span.first + 1) << 16) - a;
+					span.lastWeight = b - ((uint64)span.last << 16);
+				}
+			}
+			return;
+		}
+		static uint32 AreaWeight(const AreaSpan& span, uint32 i)
+		{
+			return i == span.first ? span.firstWeight : (i == span.last ? span.lastWeight : 65536);
+		}
+
+		//Turns a row into 4 values per pixel (b, g, r, a) to be averaged
+		//Colours are weighted by alpha (c * a) unless the image is premultiplied (c * 255), alpha is stored as a * 255
+		void AreaWeightRow(uint32* dst, const Pixel* src) const
+		{
+			for (uint32 i = 0; i < width; ++i)
+			{
+				uint32 argb = src[i].getARGB(), a = argb >> 24;
+				uint32 colourWeight = premultiplied ? 255 : a;
+				dst[(i * 4)] = (argb & 0xFF) * colourWeight;
+				dst[(i * 4) + 1] = ((argb >> 8) & 0xFF) * colourWeight;
+				dst[(i * 4) + 2] = ((argb >> 16) & 0xFF) * colourWeight;
+				dst[(i * 4) + 3] = a * 255;
+			}
+			return;
+		}
+
+		//Box filter resize where each destination pixel is the average of the source area it covers (partly covered pixels are weighted)
+		//Source rows are summed into one row per destination row, then that row is summed over each destination span
+		//Each source pixel is read once or twice whatever the scale, ratios don't need to be integers and either axis can be upscaled
+		void ResizeAreaAverage(const std::vector<Pixel>& pixels, std::vector<Pixel>& data, uint32 newWidth, uint32 newHeight, ExecutionPolicy policy)
+		{
+			std::vector<AreaSpan> xSpans, ySpans;
+			BuildAreaSpans(xSpans, width, newWidth);
+			BuildAreaSpans(ySpans, height, newHeight);
+			const uint32 rowSize = width * 4;
+			const uint32 rowsPerOutput = (height / newHeight) + 1;
+
+			ThreadPool::getShared().run(policy, newHeight, ThreadPool::chunkSize(width * rowsPerOutput), [&](uint32 begin, uint32 end)
+			{
+				std::vector<uint32> row(rowSize);
+				std::vector<uint64> sum(rowSize);
+				uint32 rowIndex = 0xFFFFFFFF;
+				for (uint32 y = begin; y < end; ++y)
+				{
+					const AreaSpan& ySpan = ySpans[y];
+					for (uint32 i = ySpan.first; i <= ySpan.last; ++i)
+					{
+						//The last row of a span is often the first row of the next one
+						if (i != rowIndex){AreaWeightRow(row.data(), &pixels[i * width]), rowIndex = i;
+						}
+						const uint64 w = AreaWeight(ySpan, i);
+						if (i == ySpan.first)
+						{
+							for (uint32 j = 0; j < rowSize; ++j)
+							{
+								sum[j] = row[j] * w;
+							}
+						}
+						else if (w == 65536)
+						{
+							for (uint32 j = 0; j < rowSize; ++j)
+							{
+								sum[j] += (uint64)row[j] << 16;
+							}
+						}
+						else {
+							for (uint32 j = 0; j < rowSize; ++j)
+							{
+								sum[j] += row[j] * w;
+							}
+						}
+					}
+
+					Pixel* dst = &data[y * newWidth];
+					for (uint32 x = 0; x < newWidth; ++x)
+					{
+						const AreaSpan& xSpan = xSpans[x];
+						//The column sums are up to 2^48 per source pixel covered, so the weighted total of a large area would overflow 64 bits
+						double total[4] = {0.0, 0.0, 0.0, 0.0};
+						for (uint32 i = xSpan.first; i <= xSpan.last; ++i)
+						{
+							const double w = AreaWeight(xSpan, i);
+							for (uint32 c = 0; c < 4; ++c)
+							{
+								total[c] += sum[(i * 4) + c] * w;
+							}
+						}
+
+						//total / area is the average of the values from AreaWeightRow()
+						const double alphaScale = xSpan.reciprocal * ySpan.reciprocal * (1.0 / 255.0);
+						uint8 colour[3];
+						for (uint32 c = 0; c < 3; ++c)
+						{
+							if (premultiplied){colour[c] = std::min((total[c] * alphaScale) + 0.5, 255.0);
+							} else colour[c] = total[3] == 0 ? 0 : std::min(((total[c] * 255.0) / total[3]) + 0.5, 255.0);
+						}
+						dst[x] = Pixel(cg::BGR(colour[2], colour[1], colour[0]), std::min((total[3] * alphaScale) + 0.5, 255.0));
+					}
+				}
+			});
+			return;
+		}
+
+		void ScanAlpha(void) const
+		{
+			bool opaque = true, clear = true;
+			for (uint32 i = 0; i < pixels.size() && (opaque || clear); i += 1024)
+			{
+				//Whole blocks are checked without branches so the loop can be vectorised
+				const uint32 end = std::min<uint32>(i + 1024, pixels.size());
+				uint8 all = 0xFF, any = 0x00;
+				for (uint32 j = i; j < end; ++j)
+				{
+					all &= pixels[j].second;
+					any |= pixels[j].second;
+				}
+				opaque = opaque && all == 0xFF;
+				clear = clear && any == 0x00;
+			}
+			alphaFlags = AlphaKnown | (opaque ? AlphaOpaque : 0) | (clear ? AlphaClear : 0);
+			return;
+		}
+
+		//Averages each 2x2 block of src into one pixel of dst, dst is max(srcWidth / 2, 1) by max(srcHeight / 2, 1)
+		//The last row or column of an odd sized image is dropped, a 1 pixel wide or high image is only halved in the other direction
+		static void HalveImage(Pixel* dst, const Pixel* src, uint32 srcWidth, uint32 srcHeight)
+		{
+			const uint32 dstWidth = std::max<uint32>(srcWidth / 2, 1), dstHeight = std::max<uint32>(srcHeight / 2, 1);
+			ThreadPool::getShared().parallelFor(dstHeight, ThreadPool::chunkSize(dstWidth), [&](uint32 begin, uint32 end)
+			{
+				for (uint32 y = begin; y < end; ++y)
+				{
+					const Pixel* r0 = &src[std::min(y * 2, srcHeight - 1) * srcWidth];
+					const Pixel* r1 = &src[std::min((y * 2) + 1, srcHeight - 1) * srcWidth];
+					Pixel* out = &dst[y * dstWidth];
+					uint32 x = 0;
+				#ifdef CG_SSE2
+					//4 source pixels from each row make 2 destination pixels
+					if (blend::UseSIMD() && srcWidth >= 2)
+					{
+						const __m128i zero = _mm_setzero_si128(), two = _mm_set1_epi16(2);
+						for (; x + 2 <= dstWidth; x += 2)
+						{
+							__m128i a = _mm_loadu_si128((const __m128i*)&r0[x * 2]), b = _mm_loadu_si128((const __m128i*)&r1[x * 2]);
+							__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+							__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+							__m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+							sum = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+							_mm_storel_epi64((__m128i*)&out[x], _mm_packus_epi16(sum, zero));
+						}
+					}
+				#endif
+					for (; x < dstWidth; ++x)
+					{
+						uint32 x0 = std::min(x * 2, srcWidth - 1), x1 = std::min((x * 2) + 1, srcWidth - 1);
+						uint32 p[4] = {r0[x0].getARGB(), r0[x1].getARGB(), r1[x0].getARGB(), r1[x1].getARGB()}, argb = 0;
+						for (uint32 c = 0; c < 32; c += 8)
+						{
+							uint32 sum = ((p[0] >> c) & 0xFF) + ((p[1] >> c) & 0xFF) + ((p[2] >> c) & 0xFF) + ((p[3] >> c) & 0xFF);
+							argb |= ((sum + 2) >> 2) << c;
+						}
+						out[x].setARGB(argb);
+					}
+				}
+			});
+			return;
+		}
+
+		//Builds every mip level down to 1x1 from the previous one
+		void BuildMipmaps(void)
+		{
+			mipLevels.clear();
+			const Image* previous = this;
+			while (previous->getWidth() > 1 || previous->getHeight() > 1)
+			{
+				std::unique_ptr<Image> level(new Image(std::max<uint32>(previous->getWidth() / 2, 1), std::max<uint32>(previous->getHeight() / 2, 1), 0, 0));
+				HalveImage(level->pixels.data(), previous->getPixelData(), previous->getWidth(), previous->getHeight());
+				level->premultiplied = premultiplied;
+				mipLevels.push_back(std::move(level));
+				previous = mipLevels.back().get();
+			}
+			return;
+		}
+
+		std::vector<Pixel> ResizeData(std::vector<Pixel>& pixels, uint32 newWidth, uint32 newHeight, InterpolationMethod m, ExecutionPolicy policy)
+		{
+			std::vector<Pixel> data;
+			float xScale = (float)width / (float)newWidth, yScale = (float)height / (float)newHeight;
+			data.resize(newWidth * newHeight);
+
+			switch (m)
+			{
+				default:
+				case InterpolationMethod::NearestNeighbor:
+				{
+					std::vector<uint32> xTable, yTable;
+					buildIndexTable(xTable, newWidth, xScale, 0, width - 1);
+					buildIndexTable(yTable, newHeight, yScale, 0, height - 1);
+					ThreadPool::getShared().run(policy, newHeight, ThreadPool::chunkSize(newWidth), [&](uint32 begin, uint32 end)
+					{
+						scaleNearest(&data[begin * newWidth], newWidth, end - begin, pixels.data(), width, xTable.data(), &yTable[begin]);
+					});
+				}
+				break;
+				
+				case InterpolationMethod::Bilinear:
+					ResizeBilinear(pixels, data, newWidth, newHeight, policy);
+				break;
+
+				case InterpolationMethod::Bicubic:
+				case InterpolationMethod::CatmullRom:
+				case InterpolationMethod::Mitchell:
+				case InterpolationMethod::Lanczos3:
+					ResizeConvolution(pixels, data, newWidth, newHeight, m, policy);
+				break;
+
+				case InterpolationMethod::Bisinusoidal:
+				{
+					ThreadPool::getShared().run(policy, newHeight, ThreadPool::chunkSize(newWidth * 16), [&](uint32 begin, uint32 end)
+					{
+						float srcX, srcY;
+						for (uint32 y = begin; y < end; ++y)
+						{
+							for (uint32 x = 0; x < newWidth; ++x)
+							{
+								srcX = x * xScale;
+								srcX /= width;
+								srcY = y * yScale;
+								srcY /= height;
+								data[(y * newWidth) + x] = samplePixel(srcX, srcY, m, ExtrapolationMethod::Extend);
+							}
+						}
+					});
+				}
+				break;
+				
+				case InterpolationMethod::AreaAveraging:
+					ResizeAreaAverage(pixels, data, newWidth, newHeight, policy);
+				break;
+			}
+			width = newWidth;
+			height = newHeight;
+			return data;
+		}
+
+	#ifdef CG_WINDOWS
+		void GetWindowSize(HWND w, uint32& width, uint32& height)
+		{
+			RECT window;
+			GetWindowRect(w, &window);
+
+			width = window.right - window.left;
+			height = window.bottom - window.top;
+			return;
+		}
+	#endif
+
+		//filter() over pixels [begin, end)
+		void FilterRange(FilterType filterType, void (*funcPtr)(std::pair<uint32, uint8>*, void*), void* funcData, uint32 begin, uint32 end)
+		{
+			switch (filterType)
+			{
+				default:
+				case FilterType::Grayscale:
+				{
+					uint8 r, g, b;
+					uint16 c;
+					for (uint32 i = begin; i < end; ++i)
+					{
+						r = cg::GetR(pixels[i].first);
+						g = cg::GetG(pixels[i].first);
+						b = cg::GetB(pixels[i].first);
+						c = (r + g + b) / 3;
+						pixels[i].first = cg::BGR(c, c, c);
+					}
+				}
+				break;
+				
+				case FilterType::WeightedGrayscale:
+				{
+					uint8 r, g, b, c;
+					for (uint32 i = begin; i < end; ++i)
+					{
+						r = cg::GetR(pixels[i].first);
+						g = cg::GetG(pixels[i].first);
+						b = cg::GetB(pixels[i].first);
+						c = (r * 0.3f) + (g * 0.59f) + (b * 0.11f);
+						pixels[i].first = cg::BGR(c, c, c);
+					}
+				}
+				break;
+
+				case FilterType::Invert:
+				{
+					for (uint32 i = begin; i < end; ++i)
+					{
+						pixels[i].first = pixels[i].first ^ 0xFFFFFF;
+					}
+				}
+				break;
+
+				case FilterType::Custom:
+				{
+					std::pair<uint32, uint8> pixel;
+					for (uint32 i = begin; i < end; ++i)
+					{
+						pixel = pixels[i];
+						funcPtr(&pixel, funcData);
+						pixels[i] = pixel;
+					}
+				}
+				break;
+			}
+			return;
+		}
+
+	public:
+		//Default constructor
+		Image()
+		{
+			width = 256;
+			height = 256;
+			aspectRatio = 1.f;
+			pixels.resize(width * height);
+		}
+		//Create an image and fill image with a colour
+		Image(uint32 width, uint32 height, uint32 rgb = 0, uint8 a = 255)
+		{
+			this->width = width;
+			this->height = height;
+			aspectRatio = (float)width / (float)height;
+			pixels.resize(width * height);
+			for (uint32 y = 0; y < height; ++y)
+			{
+				for (uint32 x = 0; x < width; ++x)
+				{
+					pixels[(y * width) + x] = Pixel(rgb, a);
+				}
+			}
+		}
+		//Load image from memory
+		Image(const uint32* data, uint32 width, uint32 height, bool alpha = false)
+		{
+			loadImageFromArray(data, width, height, alpha);
+		}
+		//Load image from memory
+		Image(const std::pair<uint32, uint8>* data, uint32 width, uint32 height)
+		{
+			loadImageFromArray(data, width, height);
+		}
+		//Load image from memory
+		Image(const Pixel* data, uint32 width, uint32 height)
+		{
+			loadImageFromArray(data, width, height);
+		}
+		//Load image from file
+		Image(const std::string fileName)
+		{
+			loadImage(fileName);
+		}
+
+		//Copy constructor
+		Image(const Image& image)
+		{
+			width = image.getWidth();
+			height = image.getHeight();
+			aspectRatio = (float)width / (float)height;
+			x = image.getPosX();
+			y = image.getPosY();
+			premultiplied = image.isPremultiplied();
+			mipmaps = image.mipmapsEnabled();
+
+			pixels.resize(width * height);
+			memcpy(&pixels[0], image.getPixelData(), width * height * sizeof(Pixel));
+		}
+		Image& operator=(const Image& image)
+		{
+			if (&image != this)
+			{
+				invalidateCache();
+				mipmaps = image.mipmapsEnabled();
+				width = image.getWidth();
+				height = image.getHeight();
+				aspectRatio = (float)width / (float)height;
+				x = image.getPosX();
+				y = image.getPosY();
+				premultiplied = image.isPremultiplied();
+
+				pixels.resize(width * height);
+				memcpy(&pixels[0], image.getPixelData(), width * height * sizeof(Pixel));
+			}
+			return *this;
+		}
+
+		Pixel* operator[](uint32 i)
+		{
+			if (i < width * height){return &pixels[i];
+			} else return nullptr;
+		}
+
+		//Loads an image from the disk (currently only supports 24 and 32 bit BMP files)
+		//ExecutionPolicy::Parallel converts the rows on the shared thread pool once the file has been read
+		bool loadImage(const std::string fileName, ExecutionPolicy policy = ExecutionPolicy::Sequential)
+		{
+			invalidateCache();
+			std::string _fileName = fileName;
+			std::transform(_fileName.begin(), _fileName.end(), _fileName.begin(), [](char c)->char {return toupper(c);});
+
+			if (_fileName.find(".BMP") != std::string::npos)
+			{
+				std::ifstream readfile(fileName, std::ios::binary);
+				if (!readfile.is_open())
+				{
+					#ifdef CG_DEBUG
+						std::cerr << "CGIMG ERROR {this->loadImage()}: Failed to read file [" << fileName << ", errno=" << errno << "]" << std::endl;
+					#endif
+					return false;
+				}
+
+				//Read header
+				std::vector<uint8> header(14);
+				readfile.read((char*)&header[0], 14 * sizeof(uint8));
+				uint32 fileSize = *(uint32*)&header[0x02];
+				uint32 imgDataOffset = *(uint32*)&header[0x0A];
+				uint32 dibHeaderSize = imgDataOffset - header.size();
+				header.resize(imgDataOffset);
+				readfile.read((char*)&header[14], dibHeaderSize * sizeof(uint8));
+
+				int32 width = *(int32*)&header[0x12];
+				int32 height = *(int32*)&header[0x16];
+
+				uint16 bitesPerPixel = *(uint16*)&header[0x1C];
+				uint16 bytesPerPixel = bitesPerPixel / 8;
+				if (bytesPerPixel < 1){bytesPerPixel = 1;
+				}
+
+				//Check if valid before loading
+				if (header[0] != 'B' || header[1] != 'M')
+				{
+					#ifdef CG_DEBUG
+						std::cerr << "CGIMG ERROR {this->loadImage()}: Invalid BMP magic number [" << fileName << "]" << std::endl;
+					#endif
+					return false;
+				}
+
+				if (bytesPerPixel < 3)
+				{
+					#ifdef CG_DEBUG
+						std::cerr << "CGIMG ERROR {this->loadImage()}: Currently only supports 24 or 32 bit BMP files [" << fileName << "]" << std::endl;
+					#endif
+					return false;
+				}// else std::cout << "BytesPerPixel=" << bytesPerPixel << std::endl;
+
+				this->width = width;
+				this->height = abs(height);
+				aspectRatio = (float)this->width / (float)this->height;
+				premultiplied = false;
+				pixels.resize(this->width * this->height);
+
+				const uint32 rowSize = width * bytesPerPixel, paddingSize = (4 - (width % 4)) % 4;
+				std::vector<uint8> imgData(fileSize - imgDataOffset);
+				readfile.read(reinterpret_cast<char*>(&imgData[0]), imgData.size() * sizeof(uint8));
+
+				ThreadPool::getShared().run(policy, this->height, ThreadPool::chunkSize(this->width), [&](uint32 begin, uint32 end)
+				{
+					for (uint32 y = begin; y < end; ++y)
+					{
+						for (uint32 x = 0; x < this->width; ++x)
+						{
+							uint32 index = ((rowSize + paddingSize) * y) + (x * bytesPerPixel);
+							uint8 red = imgData[index + 2];
+							uint8 green = imgData[index + 1];
+							uint8 blue = imgData[index];
+							uint8 alpha = (bytesPerPixel == 3 ? 255 : imgData[index + 3]);
+							pixels[(y * this->width) + x] = Pixel(cg::BGR(red, green, blue), alpha);
+						}
+					}
+				});
+
+				readfile.close();
+				if (height > 0){flipVertically(policy);
+				}
+			} else return false;
+			return true;
+		}
+
+		//Loads image from memory, format = 0xAARRGGBB
+		void loadImageFromArray(const uint32* arr, uint32 width, uint32 height, bool alpha = false)
+		{
+			invalidateCache();
+			pixels.resize(width * height);
+			this->width = width;
+			this->height = height;
+			this->aspectRatio = (float)width / (float)height;
+			premultiplied = false;
+
+			for (uint32 y = 0; y < height; ++y)
+			{
+				for (uint32 x = 0; x < width; ++x)
+				{
+					const uint32& pixel = arr[(y * width) + x];
+					uint32 rgb = cg::BGR(cg::GetR(pixel), cg::GetG(pixel), cg::GetB(pixel));
+					uint8 a = alpha ? cg::GetA(pixel) : 255;
+					pixels[(y * width) + x] = Pixel(rgb, a);
+				}
+			}
+			return;
+		}
+		//Loads image from memory, format = {0x00RRGGBB, 0xAA}
+		void loadImageFromArray(const std::pair<uint32, uint8>* arr, uint32 width, uint32 height)
+		{
+			invalidateCache();
+			pixels.resize(width * height);
+			this->width = width;
+			this->height = height;
+			this->aspectRatio = (float)width / (float)height;
+			premultiplied = false;
+
+			for (uint32 y = 0; y < height; ++y)
+			{
+				for (uint32 x = 0; x < width; ++x)
+				{
+					const uint32& rgb = arr[(y * width) + x].first;
+					const uint8& a = arr[(y * width) + x].second;
+					pixels[(y * width) + x] = Pixel(cg::BGR(cg::GetR(rgb), cg::GetG(rgb), cg::GetB(rgb)), a);
+				}
+			}
+			return;
+		}
+		//Loads image from memory, format = 0xAARRGGBB packed cg::Pixel
+		void loadImageFromArray(const Pixel* arr, uint32 width, uint32 height)
+		{
+			invalidateCache();
+			pixels.assign(arr, arr + (width * height));
+			this->width = width;
+			this->height = height;
+			this->aspectRatio = (float)width / (float)height;
+			premultiplied = false;
+			return;
+		}
+
+		//Saves image to disk (ver parameter currently unused)
+		//ExecutionPolicy::Parallel converts the rows on the shared thread pool before the file is written
+		void saveImage(const std::string fileName, uint32 ver = 0, ExecutionPolicy policy = ExecutionPolicy::Sequential)
+		{
+			std::string _fileName = fileName;
+			std::transform(_fileName.begin(), _fileName.end(), _fileName.begin(), [](char c)->char {return toupper(c);});
+
+			if (_fileName.find(".BMP"))
+			{
+				std::vector<uint8> bmpHeader(14), dibHeader(40), pixData;
+				memcpy(&bmpHeader[0x00], "BM", 2 * sizeof(char));
+				uint32 val = bmpHeader.size() + dibHeader.size();
+				memcpy(&bmpHeader[0x0A], &val, sizeof(uint32));
+
+				val = 40;
+				int32 width = this->width;
+				int32 height = this->height;
+				height = -height;
+				memcpy(&dibHeader[0x00], &val, sizeof(uint32));
+				memcpy(&dibHeader[0x04], &width, sizeof(int32));
+				memcpy(&dibHeader[0x08], &height, sizeof(int32));
+				val = 1;
+				memcpy(&dibHeader[0x0C], &val, sizeof(uint16));
+				val = 32;
+				memcpy(&dibHeader[0x0E], &val, sizeof(uint16));
+
+				const uint16 bytesPerPixel = 4;
+				const uint32 rowSize = this->width * bytesPerPixel, paddingSize = (4 - (this->width % 4)) % 4;
+				//Rows are written in place so they can be converted in any order, the padding stays 0
+				pixData.resize(this->height * (rowSize + paddingSize), 0x00);
+
+				ThreadPool::getShared().run(policy, this->height, ThreadPool::chunkSize(this->width), [&](uint32 begin, uint32 end)
+				{
+					for (uint32 y = begin; y < end; y++)
+					{
+						uint8* row = &pixData[y * (rowSize + paddingSize)];
+						for (uint32 x = 0; x < this->width; x++)
+						{
+							//BBGGRRAA
+							auto p = accessPixel(x, y);
+							row[(x * 4) + 0] = GetB(p->first);
+							row[(x * 4) + 1] = GetG(p->first);
+							row[(x * 4) + 2] = GetR(p->first);
+							row[(x * 4) + 3] = p->second;
+						}
+					}
+				});
+
+				//fileSize
+				val = bmpHeader.size() + dibHeader.size() + pixData.size();
+				memcpy(&bmpHeader[0x02], &val, sizeof(uint32));
+				val = pixData.size();
+				memcpy(&dibHeader[0x14], &val, sizeof(uint32));
+
+				std::ofstream writeFile(fileName.c_str(), std::ios::binary);
+				if (writeFile.is_open())
+				{
+					writeFile.write((char*)&bmpHeader[0], bmpHeader.size() * sizeof(char));
+					writeFile.write((char*)&dibHeader[0], dibHeader.size() * sizeof(char));
+					writeFile.write((char*)&pixData[0], pixData.size() * sizeof(char));
+					writeFile.close();
+				}
+			}
+			else {
+				#ifdef CG_DEBUG
+					std::cerr << "CGIMG ERROR {this->saveImage()}: Image type not supported. [" << fileName << "]" << std::endl;
+				#endif
+			}
+
+			return;
+		}
+
+		//FilterType::Invert = Invert all colours
+		//FilterType::Custom = Custom (pass in a function pointer, or lamda)
+		//Applies a function to all pixels in the image, funcData is not required
+		//ExecutionPolicy::Parallel splits the pixels across the shared thread pool, funcPtr is then called from several threads at once
+		void filter(FilterType filterType, void (*funcPtr)(std::pair<uint32, uint8>*, void*) = nullptr, void* funcData = nullptr, ExecutionPolicy policy = ExecutionPolicy::Sequential)
+		{
+			invalidateCache();
+			ThreadPool::getShared().run(policy, pixels.size(), ThreadPool::chunkSize(1), [&](uint32 begin, uint32 end)
+			{
+				FilterRange(filterType, funcPtr, funcData, begin, end);
+			});
+			return;
+		}
+		//Applies a function to all pixels in the image, without converting to std::pair first
+		void filter(void (*funcPtr)(Pixel*, void*), void* funcData = nullptr, ExecutionPolicy policy = ExecutionPolicy::Sequential)
+		{
+			invalidateCache();
+			ThreadPool::getShared().run(policy, pixels.size(), ThreadPool::chunkSize(1), [&](uint32 begin, uint32 end)
+			{
+				for (uint32 i = begin; i < end; ++i)
+				{
+					funcPtr(&pixels[i], funcData);
+				}
+			});
+			return;
+		}
+
+		//Returns the width of the image
+		uint32 getWidth(void) const {return width;
+		}
+		//Returns the height of the image
+		uint32 getHeight(void) const {return height;
+		}
+
+		//Sets the position of where the image will be drawn to, the image can be partly or fully outside of the buffer
+		void setPos(int32 x, int32 y)
+		{
+			this->x = x;
+			this->y = y;
+			return;
+		}
+		//Moves the position of the image
+		void move(int32 x, int32 y)
+		{
+			this->x += x;
+			this->y += y;
+			return;
+		}
+
+		//Returns X co-ordinate of the image
+		int32 getPosX(void) const {return x;
+		}
+		//Returns Y co-ordinate of the image
+		int32 getPosY(void) const {return y;
+		}
+
+		//Flips an image on the X-axis
+		void flipVertically(ExecutionPolicy policy = ExecutionPolicy::Sequential)
+		{
+			invalidateCache();
+			uint32 halfHeight = height / 2;
+			ThreadPool::getShared().run(policy, halfHeight, ThreadPool::chunkSize(width * 2), [&](uint32 begin, uint32 end)
+			{
+				for (uint32 y = begin; y < end; ++y)
+				{
+					Pixel* row = pixels.data() + (y * width);
+					std::swap_ranges(row, row + width, pixels.data() + ((height - y - 1) * width));
+				}
+			});
+			return;
+		}
+		//Flips an image on the Y-axis
+		void flipHorizontally(ExecutionPolicy policy = ExecutionPolicy::Sequential)
+		{
+			invalidateCache();
+			ThreadPool::getShared().run(policy, height, ThreadPool::chunkSize(width), [&](uint32 begin, uint32 end)
+			{
+				for (uint32 y = begin; y < end; ++y)
+				{
+					Pixel* row = pixels.data() + (y * width);
+					std::reverse(row, row + width);
+				}
+			});
+			return;
+		}
+
+		//Return a read only pointer to pixel array
+		const Pixel* getPixelData(void) const {return this->pixels.data();
+		}
+
+		//If either newWidth or newHeight == 0, the image's aspect ratio is maintained
+		//Resamples image to specified dimensions using chosen interpolation method
+		//If mipmaps are enabled, shrinking by 2x or more starts from the closest mip level
+		//ExecutionPolicy::Parallel resamples rows on the shared thread pool, small images stay on the calling thread either way
+		void resize(uint32 newWidth, uint32 newHeight, InterpolationMethod m = InterpolationMethod::NearestNeighbor, ExecutionPolicy policy = ExecutionPolicy::Sequential)
+		{
+			bool keepAspectRatio = (newWidth == 0 || newHeight == 0);
+			if (newWidth == 0){newWidth = newHeight * aspectRatio;
+			}
+			else if (newHeight == 0){newHeight = newWidth / aspectRatio;
+			}
+
+			uint32 level = selectMipLevel((float)newWidth / (float)width, (float)newHeight / (float)height);
+			if (level != 0)
+			{
+				const Image& mip = getMipLevel(level);
+				pixels = mip.pixels;
+				width = mip.getWidth();
+				height = mip.getHeight();
+			}
+
+			pixels = ResizeData(pixels, newWidth, newHeight, m, policy);
+			width = newWidth;
+			height = newHeight;
+			if (!keepAspectRatio){aspectRatio = (float)width / (float)height;
+			}
+			invalidateCache();
+			return;
+		}
+
+		//Resamples image by a scale factor using a chosen interpolation method, aspect ratio is maintained
+		void scale(float s, InterpolationMethod m = InterpolationMethod::NearestNeighbor, ExecutionPolicy policy = ExecutionPolicy::Sequential)
+		{
+			if (s > 0.f)
+			{
+				resize(width * s, height * s, m, policy);
+			}
+			return;
+		}
+
+		//Resamples image by a scale factor in each axis using a chosen interpolation method, aspect may be changed
+		void scale(float sx, float sy, InterpolationMethod m = InterpolationMethod::NearestNeighbor, ExecutionPolicy policy = ExecutionPolicy::Sequential)
+		{
+			if (sx > 0.f && sy > 0.f)
+			{
+				resize(width * sx, height * sy, m, policy);
+			}
+			return;
+		}
+
+		//Returns a pointer to a pixel without checking if it exists 
+		Pixel* accessPixel(uint32 x, uint32 y){return &pixels[(y * width) + x];
+		}
+
+		//Returns a pointer to a pixel, if pixel doesn't exist "nullptr" will be returned
+		Pixel* getPixel(uint32 x, uint32 y)
+		{
+			if (x < width && y < height){return &pixels[(y * width) + x];
+			} else return nullptr;
+		}
+
+		//Weighted sum of the pixels within the filter's radius of (posX, posY), used by samplePixel()
+		Pixel SampleFiltered(float posX, float posY, InterpolationMethod m, ExtrapolationMethod em) const
+		{
+			const int32 radius = FilterRadius(m);
+			const int32 baseX = (int32)std::floor(posX), baseY = (int32)std::floor(posY);
+			float weightX[6], weightY[6];
+			uint32 indexX[6], indexY[6];
+			for (int32 i = 0; i < radius * 2; ++i)
+			{
+				int32 sx = baseX - radius + 1 + i, sy = baseY - radius + 1 + i;
+				weightX[i] = FilterKernel(m, sx - posX);
+				weightY[i] = FilterKernel(m, sy - posY);
+				if (em == ExtrapolationMethod::Repeat)
+				{
+					indexX[i] = ((sx % (int32)width) + width) % width;
+					indexY[i] = ((sy % (int32)height) + height) % height;
+				} else {
+					indexX[i] = std::min<int32>(std::max<int32>(sx, 0), width - 1);
+					indexY[i] = std::min<int32>(std::max<int32>(sy, 0), height - 1);
+				}
+			}
+
+			float sum[4] = {0.f, 0.f, 0.f, 0.f}, total = 0.f;
+			for (int32 j = 0; j < radius * 2; ++j)
+			{
+				for (int32 i = 0; i < radius * 2; ++i)
+				{
+					float w = weightX[i] * weightY[j];
+					uint32 p = pixels[(indexY[j] * width) + indexX[i]].getARGB();
+					for (uint32 c = 0; c < 4; ++c)
+					{
+						sum[c] += ((p >> (c * 8)) & 0xFF) * w;
+					}
+					total += w;
+				}
+			}
+
+			uint8 out[4];
+			for (uint32 c = 0; c < 4; ++c)
+			{
+				out[c] = std::min(std::max((sum[c] / total) + 0.5f, 0.f), 255.f);
+			}
+			return Pixel(cg::BGR(out[2], out[1], out[0]), out[3]);
+		}
+
+		//Returns a copy of pixel at a point
+		Pixel samplePixel(float x, float y, InterpolationMethod im = InterpolationMethod::NearestNeighbor, ExtrapolationMethod em = ExtrapolationMethod::Repeat) const
+		{
+			Pixel pixel;
+			uint8 r[] = {0x00, 0x00, 0x00, 0x00};
+			uint8 g[] = {0x00, 0x00, 0x00, 0x00};
+			uint8 b[] = {0x00, 0x00, 0x00, 0x00};
+			uint8 a[] = {0xFF, 0xFF, 0xFF, 0xFF};
+
+			bool inBounds = (im != InterpolationMethod::AreaAveraging);
+			bool badX = (x < 0.f || x > 1.f);
+			bool badY = (y < 0.f || y > 1.f);
+
+			if (badX || badY)
+			{
+				switch (em)
+				{
+					case cg::ExtrapolationMethod::None:
+						inBounds = false;
+						pixel = Pixel(0x00000000, 0x00);
+						break;
+
+					case cg::ExtrapolationMethod::Repeat:
+						x = (x < 0.f ? x + 1.f : x - std::floor(x));
+						y = (y < 0.f ? y + 1.f : y - std::floor(y));
+						break;
+
+					case cg::ExtrapolationMethod::Extend:
+						x = std::min(std::max(0.f, x), 1.f);
+						y = std::min(std::max(0.f, y), 1.f);
+						break;
+				}
+			}
+
+			float posX = x * (width - 1), posY = y * (height - 1);
+			uint32 posXLower = posX, posXUpper = 0;
+			uint32 posYLower = posY, posYUpper = 0;
+			float valX = posX - std::floor(posX), valY = posY - std::floor(posY); //values used for interpolation
+
+			if (im == InterpolationMethod::NearestNeighbor || im == InterpolationMethod::None)
+			{
+				inBounds = false;
+				pixel = pixels[(std::round(posY) * width) + std::round(posX)];
+			}
+
+			if (inBounds && (im == InterpolationMethod::Bicubic || im == InterpolationMethod::CatmullRom || im == InterpolationMethod::Mitchell || im == InterpolationMethod::Lanczos3))
+			{
+				inBounds = false;
+				pixel = SampleFiltered(posX, posY, im, em);
+			}
+
+			if (inBounds)
+			{
+				switch (em)
+				{
+					case cg::ExtrapolationMethod::None:
+						break;
+
+					case cg::ExtrapolationMethod::Repeat:
+						posXUpper = (posXLower + 1) % width;
+						posYUpper = (posYLower + 1) % height;
+						break;
+
+					case cg::ExtrapolationMethod::Extend:
+						posXUpper = std::min<uint32>(std::max<uint32>(0, posXLower + 1), width - 1);
+						posYUpper = std::min<uint32>(std::max<uint32>(0, posYLower + 1), height - 1);
+						break;
+				}
+
+				uint32 index = (posYLower * width) + posXLower;
+				r[0] = cg::GetR(pixels[index].first);
+				g[0] = cg::GetG(pixels[index].first);
+				b[0] = cg::GetB(pixels[index].first);
+				a[0] = pixels[index].second;
+
+				index = (posYLower * width) + posXUpper;
+				r[1] = cg::GetR(pixels[index].first);
+				g[1] = cg::GetG(pixels[index].first);
+				b[1] = cg::GetB(pixels[index].first);
+				a[1] = pixels[index].second;
+
+				index = (posYUpper * width) + posXLower;
+				r[2] = cg::GetR(pixels[index].first);
+				g[2] = cg::GetG(pixels[index].first);
+				b[2] = cg::GetB(pixels[index].first);
+				a[2] = pixels[index].second;
+
+				index = (posYUpper * width) + posXUpper;
+				r[3] = cg::GetR(pixels[index].first);
+				g[3] = cg::GetG(pixels[index].first);
+				b[3] = cg::GetB(pixels[index].first);
+				a[3] = pixels[index].second;
+
+				int16 dR, dG, dB, dA;
+				float val;
+
+				switch (im)
+				{
+					case cg::InterpolationMethod::Bilinear:
+						dR = r[1] - r[0];
+						dG = g[1] - g[0];
+						dB = b[1] - b[0];
+						dA = a[1] - a[0];
+						r[0] = r[0] + (valX * dR); //Combined rX1
+						g[0] = g[0] + (valX * dG); //Combined gX1
+						b[0] = b[0] + (valX * dB); //Combined bX1
+						a[0] = a[0] + (valX * dA); //Combined aX1
+
+						dR = r[3] - r[2];
+						dG = g[3] - g[2];
+						dB = b[3] - b[2];
+						dA = a[3] - a[2];
+						r[1] = r[2] + (valX * dR); //Combined rX2
+						g[1] = g[2] + (valX * dG); //Combined gX2
+						b[1] = b[2] + (valX * dB); //Combined bX2
+						a[1] = a[2] + (valX * dA); //Combined aX2
+
+						dR = r[1] - r[0];
+						dG = g[1] - g[0];
+						dB = b[1] - b[0];
+						dA = a[1] - a[0];
+						r[0] = r[0] + (valY * dR); //Combined rY
+						g[0] = g[0] + (valY * dG); //Combined gY
+						b[0] = b[0] + (valY * dB); //Combined bY
+						a[0] = a[0] + (valY * dA); //Combined aY
+
+						pixel = Pixel(cg::BGR(r[0], g[0], b[0]), a[0]);
+						break;
+
+					case cg::InterpolationMethod::Bisinusoidal:
+						val = (-0.5f * std::cos(3.14159f * valX)) + 0.5f;
+						dR = r[1] - r[0];
+						dG = g[1] - g[0];
+						dB = b[1] - b[0];
+						dA = a[1] - a[0];
+						r[0] = (dR * val) + r[0]; //Combined rX1
+						g[0] = (dG * val) + g[0]; //Combined gX1
+						b[0] = (dB * val) + b[0]; //Combined bX1
+						a[0] = (dA * val) + a[0]; //Combined aX1
+
+						dR = r[3] - r[2];
+						dG = g[3] - g[2];
+						dB = b[3] - b[2];
+						dA = a[3] - a[2];
+						r[1] = (dR * val) + r[2]; //Combined rX2
+						g[1] = (dG * val) + g[2]; //Combined gX2
+						b[1] = (dB * val) + b[2]; //Combined bX2
+						a[1] = (dA * val) + a[2]; //Combined aX2
+
+						val = (-0.5f * std::cos(3.14159f * valY)) + 0.5f;
+						dR = r[1] - r[0];
+						dG = g[1] - g[0];
+						dB = b[1] - b[0];
+						dA = a[1] - a[0];
+						r[0] = (dR * val) + r[0]; //Combined rY
+						g[0] = (dG * val) + g[0]; //Combined gY
+						b[0] = (dB * val) + b[0]; //Combined bY
+						a[0] = (dA * val) + a[0]; //Combined aY
+
+						pixel = Pixel(cg::BGR(r[0], g[0], b[0]), a[0]);
+						break;
+
+					default:
+						break;
+				}
+			}
+			
+			return pixel;
+		}
+
+		void setPixel(uint32 x, uint32 y, uint32 rgb, uint8 a = 255)
+		{
+			invalidateCache();
+			if (x < width && y < height)
+			{
+				pixels[(y * width) + x] = Pixel(rgb, a);
+			}
+			return;
+		}
+
+		//Mipmaps are half size copies of the image (box filtered) down to 1x1, they're built the first time they're needed and kept until the image changes
+		//Scaled draws (drawEX() with DrawType::Resize), resize() and sampleMipmap() then read from the closest level
+		void enableMipmaps(bool enable = true)
+		{
+			mipmaps = enable;
+			if (!enable){mipLevels.clear();
+			}
+			return;
+		}
+		bool mipmapsEnabled(void) const {return mipmaps;
+		}
+		//Drops the cached mip levels and alpha flags, call this after changing pixels through accessPixel(), getPixel() or operator[]
+		void invalidateCache(void)
+		{
+			mipLevels.clear();
+			alphaFlags = 0;
+			return;
+		}
+		//Returns the number of levels (including the image itself), 1 if mipmaps are disabled
+		uint32 getMipLevelCount(void)
+		{
+			if (mipmaps && mipLevels.empty()){BuildMipmaps();
+			}
+			return mipLevels.size() + 1;
+		}
+		//Returns a mip level (level 0 is the image itself), levels past the end return the smallest level
+		const Image& getMipLevel(uint32 level)
+		{
+			level = std::min(level, getMipLevelCount() - 1);
+			return level == 0 ? *this : *mipLevels[level - 1];
+		}
+		//Picks the level closest to a scale factor (destination size / image size), the larger of the two scales is used so the image isn't blurred more than needed
+		uint32 selectMipLevel(float scaleX, float scaleY) const
+		{
+			float scale = std::max(scaleX, scaleY);
+			uint32 level = 0;
+			if (!mipmaps){return 0;
+			}
+			//Closest in powers of 2, so the next level is used once the scale is below 1 / sqrt(2)
+			while (scale < 0.70710678f && (width >> (level + 1)) + (height >> (level + 1)) != 0)
+			{
+				scale *= 2.f;
+				++level;
+			}
+			return level;
+		}
+		//Samples the mip level closest to scale (destination size / image size), x and y are the same as samplePixel()
+		Pixel sampleMipmap(float x, float y, float scale, InterpolationMethod im = InterpolationMethod::NearestNeighbor, ExtrapolationMethod em = ExtrapolationMethod::Repeat)
+		{
+			return getMipLevel(selectMipLevel(scale, scale)).samplePixel(x, y, im, em);
+		}
+
+		//Sets all alpha values in the image
+		void setAlpha(uint8 a, ExecutionPolicy policy = ExecutionPolicy::Sequential)
+		{
+			invalidateCache();
+			ThreadPool::getShared().run(policy, pixels.size(), ThreadPool::chunkSize(1), [&](uint32 begin, uint32 end)
+			{
+				for (uint32 i = begin; i < end; ++i)
+				{
+					pixels[i].second = a;
+				}
+			});
+			alphaFlags = AlphaKnown | (a == 255 ? AlphaOpaque : 0) | (a == 0 ? AlphaClear : 0);
+			return;
+		}
+
+		//True if every pixel has an alpha of 255, such images are copied instead of blended when drawn
+		bool isOpaque(void) const
+		{
+			if (alphaFlags == 0){ScanAlpha();
+			}
+			return (alphaFlags & AlphaOpaque) != 0;
+		}
+		//True if some pixels have an alpha below 255
+		bool hasTransparency(void) const
+		{
+			return !isOpaque();
+		}
+		//True if every pixel has an alpha of 0, drawing such an image with alpha enabled does nothing
+		bool isFullyTransparent(void) const
+		{
+			if (alphaFlags == 0){ScanAlpha();
+			}
+			return (alphaFlags & AlphaClear) != 0;
+		}
+
+		//Multiplies each pixel's colour by its alpha, ConsoleGraphics and blendImage() then use the cheaper src + dst * (1 - a) blend
+		//Filters, setAlpha() etc. work on the stored values, so unpremultiply first if they need the original colours
+		void premultiplyAlpha(void)
+		{
+			if (premultiplied){return;
+			}
+			invalidateCache();
+			for (uint32 i = 0; i < pixels.size(); ++i)
+			{
+				pixels[i].first = blendPixel(0x000000, pixels[i].first, pixels[i].second);
+			}
+			premultiplied = true;
+			return;
+		}
+		//Divides each pixel's colour by its alpha (colours of fully transparent pixels are lost)
+		void unpremultiplyAlpha(void)
+		{
+			if (!premultiplied){return;
+			}
+			invalidateCache();
+			for (uint32 i = 0; i < pixels.size(); ++i)
+			{
+				uint32 a = pixels[i].second, rgb = pixels[i].first;
+				if (a == 0){pixels[i].first = 0x000000;
+				}
+				else if (a != 255)
+				{
+					uint32 r = std::min<uint32>(((GetR(rgb) * 255) + (a / 2)) / a, 255);
+					uint32 g = std::min<uint32>(((GetG(rgb) * 255) + (a / 2)) / a, 255);
+					uint32 b = std::min<uint32>(((GetB(rgb) * 255) + (a / 2)) / a, 255);
+					pixels[i].first = cg::BGR(r, g, b);
+				}
+			}
+			premultiplied = false;
+			return;
+		}
+		//Returns true if the colours are premultiplied by alpha
+		bool isPremultiplied(void) const {return premultiplied;
+		}
+
+		//Replaces the alpha value of all pixels with certain colour
+		void setColourToAlpha(uint32 rgb, uint8 a = 0, ExecutionPolicy policy = ExecutionPolicy::Sequential)
+		{
+			invalidateCache();
+			ThreadPool::getShared().run(policy, pixels.size(), ThreadPool::chunkSize(1), [&](uint32 begin, uint32 end)
+			{
+				for (uint32 i = begin; i < end; ++i)
+				{
+					if (pixels[i].first == (rgb & 0x00FFFFFF)){pixels[i].second = a;
+					}
+				}
+			});
+			return;
+		}
+
+		//Change the image's dimensions (does not resample image)
+		void setSize(uint32 newWidth, uint32 newHeight, bool clearData = false)
+		{
+			invalidateCache();
+			auto temp = pixels;
+			pixels.clear();
+			pixels.resize(newWidth * newHeight);
+			if (!clearData)
+			{
+				for (uint32 y = 0; y < height; y++)
+				{
+					for (uint32 x = 0; x < width; x++)
+					{
+						pixels[(y * newWidth) + x] = temp[(y * width) + x];
+					}
+				}
+			}
+			width = newWidth;
+			height = newHeight;
+			aspectRatio = (float)width / (float)height;
+			return;
+		}
+
+		//Copy a section from a section of an image, to another (currently very slow)
+		void copy(Image& image, uint32 dstX, uint32 dstY, uint32 srcX, uint32 srcY, uint32 width, uint32 height, bool alpha = false)
+		{
+			invalidateCache();
+			for (uint32 iy = 0; iy < height; iy++)
+			{
+				for (uint32 ix = 0; ix < width; ix++)
+				{
+					if (getPixel(ix + dstX, iy + dstY) != nullptr && image.getPixel(ix + srcX, iy + srcY) != nullptr)
+					{
+						pixels[((iy + dstY) * this->width) + (ix + dstX)] = Pixel(image.getPixelData()[((iy + srcY) * image.getWidth()) + (ix + srcX)].first, alpha ? image.getPixelData()[((iy + srcY) * image.getWidth()) + (ix + srcX)].second : 255);
+					}
+				}
+			}
+			return;
+		}
+
+		//Draws a section from an section, to another
+		void blendImage(Image& image, uint32 dstX, uint32 dstY, uint32 srcX, uint32 srcY, uint32 width, uint32 height, bool keepAlpha = true, bool mask = true)
+		{
+			invalidateCache();
+			if (dstX >= this->width || dstY >= this->height || srcX >= image.getWidth() || srcY >= image.getHeight()){return;
+			}
+			width = std::min(width, std::min(this->width - dstX, image.getWidth() - srcX));
+			height = std::min(height, std::min(this->height - dstY, image.getHeight() - srcY));
+
+			for (uint32 iy = 0; iy < height; iy++)
+			{
+				const Pixel* src = &image.getPixelData()[((iy + srcY) * image.getWidth()) + srcX];
+				Pixel* dst = &pixels[((iy + dstY) * this->width) + dstX];
+				if (image.isPremultiplied()){blendRowPremultiplied(dst, src, width);
+				} else blendRow(dst, src, width);
+				if (!keepAlpha)
+				{
+					for (uint32 ix = 0; ix < width; ix++)
+					{
+						if (!mask || src[ix].second != 0){dst[ix].second = src[ix].second;
+						}
+					}
+				}
+			}
+			return;
+		}
+	};
+
+	struct Size
+	{
+		uint32 width, height;
+
+		Size()
+		{
+			width = 0, height = 0;
+		}
+		Size(uint32 width, uint32 height)
+		{
+			this->width = width;
+			this->height = height;
+		}
+	};
+
+	struct Rect
+	{
+		uint32 x, y, width, height;
+
+		Rect()
+		{
+			x = 0, y = 0, width = 0, height = 0;
+		}
+		Rect(uint32 x, uint32 y, uint32 width, uint32 height)
+		{
+			this->x = x;
+			this->y = y;
+			this->width = width;
+			this->height = height;
+		}
+
+		uint32 right(void) const {return x + width;
+		}
+		uint32 bottom(void) const {return y + height;
+		}
+		uint64 area(void) const {return (uint64)width * height;
+		}
+	};
+
+	struct SubImageData
+	{
+		Size size;
+		uint32 srcX, srcY, dstX, dstY;
+		bool isVertical, transparency;
+
+		SubImageData()
+		{
+			srcX = 0, srcY = 0;
+			dstX = 0, dstY = 0;
+			isVertical = false;
+			transparency = false;
+		}
+		SubImageData(uint32 srcX, uint32 srcY, uint32 dstX, uint32 dstY, uint32 width, uint32 height, bool isVertical, bool transparency = false)
+		{
+			this->srcX = srcX;
+			this->srcY = srcY;
+			this->dstX = dstX;
+			this->dstY = dstY;
+			size.width = width;
+			size.height = height;
+			this->isVertical = isVertical;
+			this->transparency = transparency;
+		}
+	};
+
+	//One segment for ConsoleGraphics::drawLines(), the end points may be outside of the buffer
+	struct LineSegment
+	{
+		int32 x0, y0, x1, y1;
+		uint32 rgb;
+		uint8 alpha;
+
+		LineSegment()
+		{
+			x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+			rgb = 0;
+			alpha = 255;
+		}
+		LineSegment(int32 x0, int32 y0, int32 x1, int32 y1, uint32 rgb, uint8 alpha = 255)
+		{
+			this->x0 = x0;
+			this->y0 = y0;
+			this->x1 = x1;
+			this->y1 = y1;
+			this->rgb = rgb;
+			this->alpha = alpha;
+		}
+	};
+
+	//2x3 affine transform, x' = (a * x) + (b * y) + c and y' = (d * x) + (e * y) + f
+	//translate(), scale(), rotate() and shear() apply after the existing transform, so they read in the order they are called
+	struct AffineTransform
+	{
+		float a, b, c, d, e, f;
+
+		AffineTransform()
+		{
+			a = 1.f, b = 0.f, c = 0.f;
+			d = 0.f, e = 1.f, f = 0.f;
+		}
+		AffineTransform(float a, float b, float c, float d, float e, float f)
+		{
+			this->a = a, this->b = b, this->c = c;
+			this->d = d, this->e = e, this->f = f;
+		}
+
+		AffineTransform& translate(float x, float y)
+		{
+			c += x;
+			f += y;
+			return *this;
+		}
+		AffineTransform& scale(float x, float y)
+		{
+			a *= x, b *= x, c *= x;
+			d *= y, e *= y, f *= y;
+			return *this;
+		}
+		//Angle is in radians, positive angles turn clockwise on screen because y points down
+		AffineTransform& rotate(float angle)
+		{
+			const float cs = cos(angle), sn = sin(angle);
+			*this = AffineTransform((cs * a) - (sn * d), (cs * b) - (sn * e), (cs * c) - (sn * f), (sn * a) + (cs * d), (sn * b) + (cs * e), (sn * c) + (cs * f));
+			return *this;
+		}
+		AffineTransform& shear(float x, float y)
+		{
+			*this = AffineTransform(a + (x * d), b + (x * e), c + (x * f), d + (y * a), e + (y * b), f + (y * c));
+			return *this;
+		}
+		void apply(float x, float y, float& outX, float& outY) const
+		{
+			outX = (a * x) + (b * y) + c;
+			outY = (d * x) + (e * y) + f;
+			return;
+		}
+		//Returns false if the transform squashes everything onto a line or a point
+		bool invert(AffineTransform& inverse) const
+		{
+			const double det = ((double)a * e) - ((double)b * d);
+			if (det == 0.0){return false;
+			}
+			inverse = AffineTransform((float)(e / det), (float)(-b / det), (float)(((b * (double)f) - (e * (double)c)) / det), (float)(-d / det), (float)(a / det), (float)(((d * (double)c) - (a * (double)f)) / det));
+			return true;
+		}
+	};
+
+	//Counts from ConsoleGraphics::flushCommands() and ConsoleGraphics::replayCommands()
+	struct CommandStats
+	{
+		uint32 commands; //Commands recorded
+		uint32 culled; //Commands outside the buffer or hidden by a later command that covers the whole buffer
+		uint32 batches; //Runs of drawn commands with the same type and image
+
+		CommandStats()
+		{
+			commands = 0, culled = 0, batches = 0;
+		}
+	};
+
+	//One filled triangle for ConsoleGraphics::drawTriangles()
+	struct Triangle
+	{
+		float x0, y0, x1, y1, x2, y2;
+		uint32 rgb;
+		uint8 alpha;
+
+		Triangle()
+		{
+			x0 = 0.f, y0 = 0.f, x1 = 0.f, y1 = 0.f, x2 = 0.f, y2 = 0.f;
+			rgb = 0;
+			alpha = 255;
+		}
+		Triangle(float x0, float y0, float x1, float y1, float x2, float y2, uint32 rgb, uint8 alpha = 255)
+		{
+			this->x0 = x0;
+			this->y0 = y0;
+			this->x1 = x1;
+			this->y1 = y1;
+			this->x2 = x2;
+			this->y2 = y2;
+			this->rgb = rgb;
+			this->alpha = alpha;
+		}
+	};
+
+	class Text
+	{
+		Image* font = nullptr;
+		std::string text;
+		uint32 charWidth, charHeight;
+		Image textImage;
+
+		protected:
+	
+		void getTextSize(std::string text, uint32& width, uint32& height)
+		{
+			width = 0;
+			height = 1;
+
+			std::vector<uint32> sizes;
+
+			for (uint32 i = 0; i < text.size(); ++i)
+			{
+				if (text[i] == '\n')
+				{
+					sizes.push_back(width);
+					width = 0;
+					++height;
+				} else ++width;
+			}
+
+			if (height != 1)
+			{
+				for (uint32 i = 0; i < sizes.size(); ++i)
+				{
+					if (width < sizes[i]){width = sizes[i];
+					}
+				}
+			}
+			width = std::max<uint32>(width, 1);
+		}
+	public:
+		Text()
+		{
+			this->charWidth = 0;
+			this->charHeight = 0;
+		}
+		Text(Image* fontImage, uint32 charWidth, uint32 charHeight, const std::string text)
+		{
+			this->font = fontImage;
+			this->charWidth = charWidth;
+			this->charHeight = charHeight;
+			this->text = text;
+			setText(text);
+		}
+		~Text()
+		{
+			this->font = nullptr;
+		}
+
+		//Pass in image pointer with font loaded to save memory
+		void setFont(Image* fontImage, uint32 charWidth, uint32 charHeight)
+		{
+			font = fontImage;
+			this->charWidth = charWidth;
+			this->charHeight = charHeight;
+			return;
+		}
+		void setCharSize(uint32 charWidth, uint32 charHeight)
+		{
+			this->charWidth = charWidth;
+			this->charHeight = charHeight;
+			return;
+		}
+		void setPos(int32 x, int32 y)
+		{
+			textImage.setPos(x, y);
+			return;
+		}
+		int32 getPosX(void){return textImage.getPosX();
+		}
+		int32 getPosY(void){return textImage.getPosY();
+		}
+
+		void setText(const std::string text, uint32 compX = 0, uint32 compY = 0)
+		{
+			this->text = text;
+			uint32 textWidth, textHeight;
+			getTextSize(text, textWidth, textHeight);
+			textImage.setSize((textWidth * charWidth) - (compX * textWidth), (textHeight * charHeight) - (compY * textHeight), true);
+			uint32 srcX = 0, srcY = 0, dstX = 0, dstY = 0;
+
+			for (uint32 i = 0; i < text.size(); ++i)
+			{
+				uint8 c = text[i];
+				srcX = c * charWidth;
+
+				switch (c)
+				{
+					case '\n':
+						dstX = 0;
+						dstY++;
+						break;
+
+					default:
+						textImage.copy(*font, (dstX * charWidth) - (compX * dstX), (dstY * charHeight) - (compY * dstY), srcX, 0, charWidth, charHeight, true);
+						dstX++;
+						break;
+				}
+			}
+			return;
+		}
+
+		std::string getText(void){return text;
+		}
+		Image& getTextImage(void){return textImage;
+		}
+		Image* getFontImage(void){return font;
+		}
+
+		uint32 getCharWidth(void){return charWidth;
+		}
+		uint32 getCharHeight(void){return charHeight;
+		}
+		uint32 getWidth(void){return textImage.getWidth();
+		}
+		uint32 getHeight(void){return textImage.getHeight();
+		}
+	};
+
+	//Describes how a frame should be output by a RenderBackend
+	struct PresentInfo
+	{
+		uint32 width, height; //Size of the buffer
+		uint32 outputX, outputY, outputWidth, outputHeight; //Where the buffer is output to (outputWidth and outputHeight are not scaled)
+		float outputScale;
+		uint16 pixelSize;
+		RenderMode mode;
+		//Parts of the buffer that changed since the last frame (see ConsoleGraphics::enableDirtyRects()), nullptr means the whole buffer
+		const Rect* dirtyRects;
+		uint32 dirtyRectCount;
+	};
+
+	//Owns the buffer ConsoleGraphics draws into and outputs it when ConsoleGraphics::display() is called
+	class RenderBackend
+	{
+	public:
+		virtual ~RenderBackend(){}
+
+		//Returns a width * height buffer (0x00RRGGBB) to draw into, the old buffer may be freed so only call when the size changes
+		virtual uint32* createBuffer(uint32 width, uint32 height) = 0;
+		//Outputs a frame, pixels is normally the buffer returned by createBuffer()
+		virtual bool present(const uint32* pixels, const PresentInfo& info) = 0;
+	};
+
+	//Keeps the buffer in memory and doesn't output it anywhere (used for headless rendering, benchmarks and regression tests)
+	class MemoryBackend : public RenderBackend
+	{
+		std::vector<uint32> buffer, capturedFrame;
+		uint32 capturedWidth = 0, capturedHeight = 0;
+		uint64 frameCount = 0;
+		bool capture = false, captured = false;
+		bool frameStale = true; //capturedFrame missed a presented frame, so the next one is copied whole
+		void(*frameFunc)(const uint32*, uint32, uint32, uint64, void*) = nullptr;
+		void* frameFuncData = nullptr;
+		//"frameFunc" function struct
+		//Arg 1 = Pointer to the presented frame, 0x00RRGGBB (only valid during the call)
+		//Arg 2 = Width
+		//Arg 3 = Height
+		//Arg 4 = Frame number
+		//Arg 5 = Extra data
+
+		//The buffer's top byte can hold anything (e.g. a copied image's alpha), frames are handed out as 0x00RRGGBB
+		static void CopyFrameRow(uint32* dst, const uint32* src, uint32 count)
+		{
+			for (uint32 i = 0; i < count; ++i)
+			{
+				dst[i] = src[i] & 0x00FFFFFF;
+			}
+			return;
+		}
+
+	public:
+		MemoryBackend(bool captureFrames = false)
+		{
+			capture = captureFrames;
+		}
+
+		uint32* createBuffer(uint32 width, uint32 height) override
+		{
+			buffer.assign(width * height, 0);
+			return buffer.data();
+		}
+		bool present(const uint32* pixels, const PresentInfo& info) override
+		{
+			if (!capture && frameFunc == nullptr)
+			{
+				frameStale = true;
+				++frameCount;
+				return true;
+			}
+			if (info.dirtyRects != nullptr && !frameStale && capturedWidth == info.width && capturedHeight == info.height)
+			{
+				//Only the changed parts need copying
+				for (uint32 i = 0; i < info.dirtyRectCount; ++i)
+				{
+					const Rect& r = info.dirtyRects[i];
+					for (uint32 y = r.y; y < r.bottom(); ++y)
+					{
+						CopyFrameRow(&capturedFrame[(y * info.width) + r.x], &pixels[(y * info.width) + r.x], r.width);
+					}
+				}
+			}
+			else
+			{
+				capturedFrame.resize(info.width * info.height);
+				CopyFrameRow(capturedFrame.data(), pixels, info.width * info.height);
+				capturedWidth = info.width;
+				capturedHeight = info.height;
+				frameStale = false;
+			}
+			captured = captured || capture;
+			if (frameFunc != nullptr){frameFunc(capturedFrame.data(), info.width, info.height, frameCount, frameFuncData);
+			}
+			++frameCount;
+			return true;
+		}
+
+		//Copy every presented frame so it can be read with getCapturedFrame()
+		void setCapture(bool captureFrames)
+		{
+			capture = captureFrames;
+			return;
+		}
+		//Call a function every time a frame is presented
+		void setFrameCallback(void(*funcPtr)(const uint32*, uint32, uint32, uint64, void*), void* funcData = nullptr)
+		{
+			frameFunc = funcPtr;
+			frameFuncData = funcData;
+			return;
+		}
+
+		//Returns the last captured frame (0x00RRGGBB, nullptr if nothing has been captured)
+		const uint32* getCapturedFrame(void) const {return !captured || capturedFrame.empty() ? nullptr : capturedFrame.data();
+		}
+		uint32 getCapturedWidth(void) const {return capturedWidth;
+		}
+		uint32 getCapturedHeight(void) const {return capturedHeight;
+		}
+		//Returns the number of frames presented
+		uint64 getFrameCount(void) const {return frameCount;
+		}
+	};
+
+	//Outputs to a VT terminal using 24-bit colour escape codes, only the cells that changed since the last frame are written
+	//RenderMode::TerminalHalfBlock = 1x2 pixels per cell using the upper half block character
+	//RenderMode::TerminalBraille = 2x4 pixels per cell using braille dots, each cell is fitted to a foreground and background colour
+	//RenderMode::TerminalQuadrant = 2x2 pixels per cell using quadrant block characters, each cell is fitted to a foreground and background colour
+	//outputX and outputY are used as the column and row of the top left cell, pixelSize and outputScale are ignored
+	class TerminalBackend : public RenderBackend
+	{
+		struct Cell
+		{
+			uint32 fg, bg, glyph; //glyph is a unicode code point, fg isn't used when glyph == ' '
+
+			bool operator==(const Cell& c) const {return glyph == c.glyph && bg == c.bg && (glyph == ' ' || fg == c.fg);
+			}
+			bool operator!=(const Cell& c) const {return !(*this == c);
+			}
+		};
+
+		static const uint32 noColour = 0xFFFFFFFF;
+
+		std::vector<uint32> buffer;
+		std::vector<Cell> cells, prevCells;
+		uint32 columns = 0, rows = 0, originX = 0, originY = 0;
+		uint32 currentFg = noColour, currentBg = noColour;
+		std::string output;
+		FILE* stream;
+		bool fullRedraw = true;
+		RenderMode lastMode = RenderMode::TerminalHalfBlock;
+		uint64 frameCount = 0, lastFrameBytes = 0;
+		uint32 lastChangedCells = 0;
+
+		static void AppendNumber(std::string& str, uint32 n)
+		{
+			char digits[10];
+			uint8 count = 0;
+			do
+			{
+				digits[count++] = '0' + (n % 10);
+				n /= 10;
+			} while (n != 0);
+			while (count > 0){str.push_back(digits[--count]);
+			}
+			return;
+		}
+		static void AppendColour(std::string& str, uint32 rgb)
+		{
+			AppendNumber(str, (rgb >> 16) & 0xFF);
+			str.push_back(';');
+			AppendNumber(str, (rgb >> 8) & 0xFF);
+			str.push_back(';');
+			AppendNumber(str, rgb & 0xFF);
+			return;
+		}
+		static void AppendUTF8(std::string& str, uint32 c)
+		{
+			if (c < 0x80){str.push_back((char)c);
+			}
+			else if (c < 0x800)
+			{
+				str.push_back((char)(0xC0 | (c >> 6)));
+				str.push_back((char)(0x80 | (c & 0x3F)));
+			} else {
+				str.push_back((char)(0xE0 | (c >> 12)));
+				str.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+				str.push_back((char)(0x80 | (c & 0x3F)));
+			}
+			return;
+		}
+
+		void ResizeCells(uint32 columns, uint32 rows)
+		{
+			if (columns != this->columns || rows != this->rows)
+			{
+				this->columns = columns;
+				this->rows = rows;
+				cells.resize(columns * rows);
+				prevCells.resize(columns * rows);
+				fullRedraw = true;
+			}
+			return;
+		}
+
+		//Only cell rows in [rowBegin, rowEnd) are rebuilt
+		void BuildHalfBlockCells(const uint32* pixels, uint32 width, uint32 height, uint32 rowBegin = 0, uint32 rowEnd = 0xFFFFFFFF)
+		{
+			ResizeCells(width, (height + 1) / 2);
+			for (uint32 row = rowBegin; row < std::min(rowEnd, rows); ++row)
+			{
+				const uint32* top = &pixels[(row * 2) * width];
+				const uint32* bottom = (row * 2) + 1 < height ? top + width : top;
+				Cell* cell = &cells[row * columns];
+				for (uint32 x = 0; x < width; ++x)
+				{
+					uint32 t = top[x] & 0x00FFFFFF, b = bottom[x] & 0x00FFFFFF;
+					cell[x].glyph = t == b ? ' ' : 0x2580; //Upper half block
+					cell[x].fg = t;
+					cell[x].bg = b;
+				}
+			}
+			return;
+		}
+
+		//Luminance (0-255) of a row of 0x00RRGGBB pixels
+		static void LuminanceRow(const uint32* pixels, uint8* lum, uint32 count)
+		{
+			uint32 i = 0;
+		#ifdef CG_SSE2
+			const __m128i maskBR = _mm_set1_epi32(0x00FF00FF), weightBR = _mm_set1_epi32((77 << 16) | 29), weightG = _mm_set1_epi32(150);
+			for (; i + 8 <= count; i += 8)
+			{
+				__m128i p0 = _mm_loadu_si128((const __m128i*)&pixels[i]), p1 = _mm_loadu_si128((const __m128i*)&pixels[i + 4]);
+				//(b * 29) + (r * 77) + (g * 150), 16-bit words are multiplied and summed in pairs
+				__m128i l0 = _mm_add_epi32(_mm_madd_epi16(_mm_and_si128(p0, maskBR), weightBR), _mm_madd_epi16(_mm_srli_epi16(p0, 8), weightG));
+				__m128i l1 = _mm_add_epi32(_mm_madd_epi16(_mm_and_si128(p1, maskBR), weightBR), _mm_madd_epi16(_mm_srli_epi16(p1, 8), weightG));
+				__m128i l = _mm_packs_epi32(_mm_srli_epi32(l0, 8), _mm_srli_epi32(l1, 8));
+				_mm_storel_epi64((__m128i*)&lum[i], _mm_packus_epi16(l, l));
+			}
+		#endif
+			for (; i < count; ++i)
+			{
+				uint32 p = pixels[i];
+				lum[i] = ((((p >> 16) & 0xFF) * 77) + (((p >> 8) & 0xFF) * 150) + ((p & 0xFF) * 29)) >> 8;
+			}
+			return;
+		}
+
+		//Splits a row of cells (2 pixels wide, cellHeight pixels high) into pixels brighter than the middle of each cell's luminance range
+		//rowMasks[r][c] has bit 0 (left pixel) and bit 1 (right pixel) set for cell c in row r
+		static void ThresholdCells(uint8* const* lum, uint32 cellHeight, uint32 columns, uint8* const* rowMasks)
+		{
+			uint32 c = 0;
+		#ifdef CG_SSE2
+			const __m128i lowBytes = _mm_set1_epi16(0x00FF), signBit = _mm_set1_epi8((char)0x80);
+			for (; c + 8 <= columns; c += 8)
+			{
+				__m128i row[4] = {_mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128()}, lo, hi;
+				for (uint32 r = 0; r < cellHeight; ++r)
+				{
+					row[r] = _mm_loadu_si128((const __m128i*)&lum[r][c * 2]);
+				}
+				lo = row[0], hi = row[0];
+				for (uint32 r = 1; r < cellHeight; ++r)
+				{
+					lo = _mm_min_epu8(lo, row[r]);
+					hi = _mm_max_epu8(hi, row[r]);
+				}
+				//Reduce each pair of columns to the cell's min/max, then copy the threshold back to both bytes
+				lo = _mm_and_si128(_mm_min_epu8(lo, _mm_srli_epi16(lo, 8)), lowBytes);
+				hi = _mm_and_si128(_mm_max_epu8(hi, _mm_srli_epi16(hi, 8)), lowBytes);
+				__m128i threshold = _mm_avg_epu8(lo, hi);
+				threshold = _mm_xor_si128(_mm_or_si128(threshold, _mm_slli_epi16(threshold, 8)), signBit);
+
+				for (uint32 r = 0; r < cellHeight; ++r)
+				{
+					uint32 bits = _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_xor_si128(row[r], signBit), threshold));
+					for (uint32 i = 0; i < 8; ++i)
+					{
+						rowMasks[r][c + i] = (bits >> (i * 2)) & 0x03;
+					}
+				}
+			}
+		#endif
+			for (; c < columns; ++c)
+			{
+				uint8 lo = 255, hi = 0;
+				for (uint32 r = 0; r < cellHeight; ++r)
+				{
+					lo = std::min(lo, std::min(lum[r][c * 2], lum[r][(c * 2) + 1]));
+					hi = std::max(hi, std::max(lum[r][c * 2], lum[r][(c * 2) + 1]));
+				}
+				uint8 threshold = (lo + hi + 1) / 2;
+				for (uint32 r = 0; r < cellHeight; ++r)
+				{
+					rowMasks[r][c] = (lum[r][c * 2] > threshold ? 0x01 : 0x00) | (lum[r][(c * 2) + 1] > threshold ? 0x02 : 0x00);
+				}
+			}
+			return;
+		}
+
+		//Rounded sum / count for count <= 8 without dividing
+		static uint32 Mean(uint32 sum, uint32 count)
+		{
+			static const uint32 reciprocal[9] = {0, 65536, 32768, 21846, 16384, 13108, 10923, 9363, 8192};
+			return ((sum + (count / 2)) * reciprocal[count]) >> 16;
+		}
+
+		//Fits every 2xcellHeight block of pixels to two colours, cell rows are split across the shared thread pool
+		void BuildTwoColourCells(const uint32* pixels, uint32 width, uint32 height, uint32 cellHeight, uint32 rowBegin = 0, uint32 rowEnd = 0xFFFFFFFF)
+		{
+			//Quadrant glyphs indexed by bits (0 = top left, 1 = top right, 2 = bottom left, 3 = bottom right)
+			static const uint32 quadrants[16] = {' ', 0x2598, 0x259D, 0x2580, 0x2596, 0x258C, 0x259E, 0x259B, 0x2597, 0x259A, 0x2590, 0x259C, 0x2584, 0x2599, 0x259F, 0x2588};
+			//Braille dot bits indexed by [row][left | (right << 1)]
+			static const uint8 brailleRows[4][4] = {{0x00, 0x01, 0x08, 0x09}, {0x00, 0x02, 0x10, 0x12}, {0x00, 0x04, 0x20, 0x24}, {0x00, 0x40, 0x80, 0xC0}};
+
+			ResizeCells((width + 1) / 2, (height + cellHeight - 1) / cellHeight);
+			const uint32 paddedWidth = (columns * 2) + 16;
+
+			rowEnd = std::min(rowEnd, rows);
+			if (rowBegin >= rowEnd){return;
+			}
+			ThreadPool::getShared().parallelFor(rowEnd - rowBegin, 4, [&](uint32 begin, uint32 end)
+			{
+				begin += rowBegin;
+				end += rowBegin;
+				std::vector<uint8> scratch(paddedWidth * 4), maskScratch(columns * 4);
+				uint8* lum[4];
+				uint8* rowMasks[4];
+				const uint32* rowPixels[4];
+				for (uint32 r = 0; r < 4; ++r)
+				{
+					lum[r] = &scratch[r * paddedWidth];
+					rowMasks[r] = &maskScratch[r * columns];
+				}
+
+				for (uint32 row = begin; row < end; ++row)
+				{
+					for (uint32 r = 0; r < cellHeight; ++r)
+					{
+						rowPixels[r] = &pixels[std::min((row * cellHeight) + r, height - 1) * width];
+						LuminanceRow(rowPixels[r], lum[r], width);
+						memset(&lum[r][width], lum[r][width - 1], paddedWidth - width);
+					}
+					ThresholdCells(lum, cellHeight, columns, rowMasks);
+
+					Cell* cell = &cells[row * columns];
+					for (uint32 c = 0; c < columns; ++c)
+					{
+						//Red and blue are summed together in one register, at most 8 pixels so they can't overflow into each other
+						uint32 totalRB = 0, totalG = 0, fgRB = 0, fgG = 0, bits = 0;
+						for (uint32 r = 0; r < cellHeight; ++r)
+						{
+							uint32 rowMask = rowMasks[r][c];
+							uint32 p0 = rowPixels[r][c * 2], p1 = rowPixels[r][std::min((c * 2) + 1, width - 1)];
+							uint32 m0 = 0 - (rowMask & 0x01), m1 = 0 - (rowMask >> 1);
+							totalRB += (p0 & 0x00FF00FF) + (p1 & 0x00FF00FF);
+							totalG += ((p0 >> 8) & 0xFF) + ((p1 >> 8) & 0xFF);
+							fgRB += (p0 & 0x00FF00FF & m0) + (p1 & 0x00FF00FF & m1);
+							fgG += (((p0 >> 8) & 0xFF) & m0) + (((p1 >> 8) & 0xFF) & m1);
+							bits |= cellHeight == 4 ? brailleRows[r][rowMask] : rowMask << (r * 2);
+						}
+
+						uint32 fgCount = 0;
+						for (uint32 b = bits; b != 0; b &= b - 1){++fgCount;
+						}
+						uint32 bgCount = (cellHeight * 2) - fgCount, bgRB = totalRB - fgRB, bgG = totalG - fgG;
+						cell[c].glyph = bits == 0 ? ' ' : (cellHeight == 4 ? 0x2800 + bits : quadrants[bits]);
+						cell[c].fg = fgCount == 0 ? 0 : cg::BGR(Mean(fgRB >> 16, fgCount), Mean(fgG, fgCount), Mean(fgRB & 0xFFFF, fgCount));
+						cell[c].bg = cg::BGR(Mean(bgRB >> 16, bgCount), Mean(bgG, bgCount), Mean(bgRB & 0xFFFF, bgCount));
+					}
+				}
+			});
+			return;
+		}
+
+		//Writes the cells that changed, runs of cells with the same colours share one escape sequence
+		void EmitCells(void)
+		{
+			output.clear();
+			lastChangedCells = 0;
+			if (fullRedraw)
+			{
+				output += "\x1b[0m\x1b[?25l\x1b[2J";
+				currentFg = noColour;
+				currentBg = noColour;
+			}
+
+			bool cursorValid = false;
+			for (uint32 row = 0; row < rows; ++row)
+			{
+				cursorValid = false;
+				for (uint32 x = 0; x < columns; ++x)
+				{
+					const Cell& cell = cells[(row * columns) + x];
+					Cell& prev = prevCells[(row * columns) + x];
+					if (!fullRedraw && cell == prev)
+					{
+						cursorValid = false;
+						continue;
+					}
+					prev = cell;
+					++lastChangedCells;
+
+					if (!cursorValid)
+					{
+						output += "\x1b[";
+						AppendNumber(output, originY + row + 1);
+						output.push_back(';');
+						AppendNumber(output, originX + x + 1);
+						output.push_back('H');
+						cursorValid = true;
+					}
+
+					bool setFg = cell.glyph != ' ' && cell.fg != currentFg, setBg = cell.bg != currentBg;
+					if (setFg || setBg)
+					{
+						output += "\x1b[";
+						if (setFg)
+						{
+							output += "38;2;";
+							AppendColour(output, cell.fg);
+							currentFg = cell.fg;
+						}
+						if (setBg)
+						{
+							output += setFg ? ";48;2;" : "48;2;";
+							AppendColour(output, cell.bg);
+							currentBg = cell.bg;
+						}
+						output.push_back('m');
+					}
+					AppendUTF8(output, cell.glyph);
+				}
+			}
+			fullRedraw = false;
+			return;
+		}
+
+	public:
+		TerminalBackend(FILE* stream = stdout)
+		{
+			this->stream = stream;
+		#ifdef CG_WINDOWS
+			HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+			DWORD consoleMode = 0;
+			if (console != INVALID_HANDLE_VALUE && GetConsoleMode(console, &consoleMode))
+			{
+				SetConsoleMode(console, consoleMode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+			}
+			SetConsoleOutputCP(CP_UTF8);
+		#endif
+		}
+		~TerminalBackend()
+		{
+			if (frameCount != 0)
+			{
+				fputs("\x1b[0m\x1b[?25h", stream);
+				fflush(stream);
+			}
+		}
+
+		uint32* createBuffer(uint32 width, uint32 height) override
+		{
+			buffer.assign(width * height, 0);
+			return buffer.data();
+		}
+
+		bool present(const uint32* pixels, const PresentInfo& info) override
+		{
+			if (info.outputX != originX || info.outputY != originY)
+			{
+				originX = info.outputX;
+				originY = info.outputY;
+				fullRedraw = true;
+			}
+
+			const uint32 cellHeight = info.mode == RenderMode::TerminalBraille ? 4 : 2;
+			const uint32 cellColumns = info.mode == RenderMode::TerminalBraille || info.mode == RenderMode::TerminalQuadrant ? (info.width + 1) / 2 : info.width;
+			//Cells are only rebuilt for the changed rows, unless the layout changed
+			const bool partial = info.dirtyRects != nullptr && !fullRedraw && info.mode == lastMode && cellColumns == columns && (info.height + cellHeight - 1) / cellHeight == rows;
+			lastMode = info.mode;
+			for (uint32 i = 0; i < (partial ? info.dirtyRectCount : 1); ++i)
+			{
+				const uint32 rowBegin = partial ? info.dirtyRects[i].y / cellHeight : 0;
+				const uint32 rowEnd = partial ? (info.dirtyRects[i].bottom() + cellHeight - 1) / cellHeight : 0xFFFFFFFF;
+				switch (info.mode)
+				{
+					default:
+					case RenderMode::TerminalHalfBlock:
+						BuildHalfBlockCells(pixels, info.width, info.height, rowBegin, rowEnd);
+						break;
+
+					case RenderMode::TerminalBraille:
+						BuildTwoColourCells(pixels, info.width, info.height, 4, rowBegin, rowEnd);
+						break;
+
+					case RenderMode::TerminalQuadrant:
+						BuildTwoColourCells(pixels, info.width, info.height, 2, rowBegin, rowEnd);
+						break;
+				}
+			}
+
+			EmitCells();
+			++frameCount;
+			lastFrameBytes = output.size();
+			if (!output.empty() && fwrite(output.data(), 1, output.size(), stream) != output.size())
+			{
+				#ifdef CG_DEBUG
+					std::cerr << "CGOUT ERROR {this->present()}: fwrite() failed [errno=" << errno << "]" << std::endl;
+				#endif
+				return false;
+			}
+			fflush(stream);
+			return true;
+		}
+
+		//Redraw every cell on the next frame (e.g. after the terminal has been cleared or resized)
+		void invalidate(void)
+		{
+			fullRedraw = true;
+			return;
+		}
+
+		//Returns the number of bytes written for the last frame
+		uint64 getLastFrameBytes(void) const {return lastFrameBytes;
+		}
+		//Returns the number of cells written for the last frame
+		uint32 getLastChangedCells(void) const {return lastChangedCells;
+		}
+		uint64 getFrameCount(void) const {return frameCount;
+		}
+	};
+
+#ifdef CG_WINDOWS
+	//Outputs to a window using GDI, the buffer is a DIB section that stays selected into a memory DC so display() doesn't need to copy it
+	class GDIBackend : public RenderBackend
+	{
+		HDC targetDC = NULL, memDC = NULL;
+		HBITMAP bitmap = NULL, oldBitmap = NULL;
+		uint32* bits = nullptr;
+		uint32 width = 0, height = 0;
+		std::vector<uint32> fallbackBuffer; //Used if CreateDIBSection() fails
+
+		void DeleteSection(void)
+		{
+			if (bitmap != NULL)
+			{
+				SelectObject(memDC, oldBitmap);
+				DeleteObject(bitmap);
+				bitmap = NULL;
+			}
+			bits = nullptr;
+			return;
+		}
+
+		void FillBitmapInfo(BITMAPINFO& info, uint32 width, uint32 height)
+		{
+			memset(&info, 0, sizeof(BITMAPINFO));
+			info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+			info.bmiHeader.biWidth = width;
+			info.bmiHeader.biHeight = -(int32)height; //Top-down
+			info.bmiHeader.biPlanes = 1;
+			info.bmiHeader.biBitCount = 32;
+			info.bmiHeader.biCompression = BI_RGB;
+			return;
+		}
+
+	public:
+		GDIBackend(HDC targetDC)
+		{
+			setTarget(targetDC);
+		}
+		~GDIBackend()
+		{
+			DeleteSection();
+			if (memDC != NULL){DeleteDC(memDC);
+			}
+		}
+		GDIBackend(const GDIBackend&) = delete;
+		GDIBackend& operator=(const GDIBackend&) = delete;
+
+		//Changes the DC that is drawn to, the DIB section is kept
+		void setTarget(HDC hdc)
+		{
+			HDC newDC = CreateCompatibleDC(hdc);
+			if (bitmap != NULL)
+			{
+				SelectObject(memDC, oldBitmap);
+				oldBitmap = (HBITMAP)SelectObject(newDC, bitmap);
+			}
+			if (memDC != NULL){DeleteDC(memDC);
+			}
+			memDC = newDC;
+			targetDC = hdc;
+			return;
+		}
+		HDC getTarget(void){return targetDC;
+		}
+
+		uint32* createBuffer(uint32 width, uint32 height) override
+		{
+			if (bits != nullptr && width == this->width && height == this->height){return bits;
+			}
+			DeleteSection();
+			this->width = width;
+			this->height = height;
+
+			BITMAPINFO info;
+			FillBitmapInfo(info, width, height);
+			void* sectionBits = nullptr;
+			bitmap = CreateDIBSection(memDC, &info, DIB_RGB_COLORS, &sectionBits, NULL, 0);
+			if (bitmap == NULL || sectionBits == nullptr)
+			{
+				#ifdef CG_DEBUG
+					std::cerr << "CGOUT ERROR {this->createBuffer()}: CreateDIBSection() returned 'NULL' [GetLastError()=" << GetLastError() << "]" << std::endl;
+				#endif
+				if (bitmap != NULL){DeleteObject(bitmap);
+				}
+				bitmap = NULL;
+				fallbackBuffer.assign(width * height, 0);
+				return fallbackBuffer.data();
+			}
+			fallbackBuffer.clear();
+			oldBitmap = (HBITMAP)SelectObject(memDC, bitmap);
+			bits = (uint32*)sectionBits;
+			return bits;
+		}
+
+		bool present(const uint32* pixels, const PresentInfo& info) override
+		{
+			bool returnValue = true;
+			//With dirty rectangles only the changed parts are sent to the window
+			const Rect whole(0, 0, info.width, info.height);
+			const uint32 rectCount = info.dirtyRects != nullptr ? info.dirtyRectCount : 1;
+
+			switch (info.mode)
+			{
+				default:
+				case RenderMode::BitBltInv:
+				case RenderMode::BitBlt:
+				{
+					DWORD rop = info.mode == RenderMode::BitBltInv ? NOTSRCCOPY : SRCCOPY;
+					uint32 outputWidth = info.outputWidth * info.outputScale, outputHeight = info.outputHeight * info.outputScale;
+					if (pixels == bits && bits != nullptr)
+					{
+						GdiFlush(); //Make sure GDI isn't still using the section
+						for (uint32 i = 0; i < rectCount; ++i)
+						{
+							const Rect& r = info.dirtyRects != nullptr ? info.dirtyRects[i] : whole;
+							//Neighbouring rectangles are scaled to the same edges so there are no gaps between them
+							const int32 x0 = info.outputX + (int32)(((uint64)r.x * outputWidth) / info.width), x1 = info.outputX + (int32)(((uint64)r.right() * outputWidth) / info.width);
+							const int32 y0 = info.outputY + (int32)(((uint64)r.y * outputHeight) / info.height), y1 = info.outputY + (int32)(((uint64)r.bottom() * outputHeight) / info.height);
+							returnValue = StretchBlt(targetDC, x0, y0, x1 - x0, y1 - y0, memDC, r.x, r.y, r.width, r.height, rop) && returnValue;
+						}
+					} else {
+						//The fallback buffer is always sent whole
+						BITMAPINFO bmi;
+						FillBitmapInfo(bmi, info.width, info.height);
+						returnValue = StretchDIBits(targetDC, info.outputX, info.outputY, outputWidth, outputHeight, 0, 0, info.width, info.height, pixels, &bmi, DIB_RGB_COLORS, rop) != 0;
+					}
+					if (!returnValue)
+					{
+						#ifdef CG_DEBUG
+							std::cerr << "CGOUT ERROR {this->present()}: StretchBlt() returned 'false' [GetLastError()=" << GetLastError() << "]" << std::endl;
+						#endif
+					}
+				}
+				break;
+
+				case RenderMode::SetPixelInv:
+				case RenderMode::SetPixel:
+					for (uint32 i = 0; i < rectCount; ++i)
+					{
+						const Rect& r = info.dirtyRects != nullptr ? info.dirtyRects[i] : whole;
+						const uint32 x1 = std::min<uint32>(r.right() * info.pixelSize, info.outputWidth), y1 = std::min<uint32>(r.bottom() * info.pixelSize, info.outputHeight);
+						for (uint32 y = r.y * info.pixelSize; y < y1; ++y)
+						{
+							for (uint32 x = r.x * info.pixelSize; x < x1; ++x)
+							{
+								uint32 p = _byteswap_ulong(pixels[((y / info.pixelSize) * info.width) + (x / info.pixelSize)]) >> 8;
+								SetPixelV(targetDC, x, y, info.mode == RenderMode::SetPixel ? p : p ^ 0x00FFFFFF); //^ 0x00FFFFFF << inverts colours
+							}
+						}
+					}
+					break;
+
+				case RenderMode::SetPixelVer:
+				case RenderMode::SetPixelVerInv:
+					for (uint32 i = 0; i < rectCount; ++i)
+					{
+						const Rect& r = info.dirtyRects != nullptr ? info.dirtyRects[i] : whole;
+						const uint32 x1 = std::min<uint32>(r.right() * info.pixelSize, info.outputWidth), y1 = std::min<uint32>(r.bottom() * info.pixelSize, info.outputHeight);
+						for (uint32 x = r.x * info.pixelSize; x < x1; ++x)
+						{
+							for (uint32 y = r.y * info.pixelSize; y < y1; ++y)
+							{
+								uint32 p = _byteswap_ulong(pixels[((y / info.pixelSize) * info.width) + (x / info.pixelSize)]) >> 8;
+								SetPixelV(targetDC, x, y, info.mode == RenderMode::SetPixelVer ? p : p ^ 0x00FFFFFF);
+							}
+						}
+					}
+					break;
+			}
+
+			return returnValue;
+		}
+	};
+#endif
+
+	//Post-Processing shader called for every pixel, it may only change the pixel it is given because rows are shaded in parallel
+	//Neighbouring rows can only be read if the shader was loaded with a halo radius
+	//Arg 1 = Pointer to current pixel
+	//Arg 2 = Buffer width
+	//Arg 3 = Buffer height
+	//Arg 4 = Current X
+	//Arg 5 = Current Y
+	//Arg 6 = Extra data
+	typedef void(*PixelShader)(uint32*, uint32, uint32, uint32, uint32, void*);
+	//Post-Processing shader called for a span of pixels in one row, it may only change the pixels in the span
+	//Arg 1 = Pointer to the first pixel in the span
+	//Arg 2 = Number of pixels in the span
+	//Arg 3 = X of the first pixel
+	//Arg 4 = Y
+	//Arg 5 = Buffer width
+	//Arg 6 = Buffer height
+	//Arg 7 = Extra data
+	typedef void(*SpanShader)(uint32*, uint32, uint32, uint32, uint32, uint32, void*);
+
+	class ConsoleGraphics
+	{
+		uint32* pixels = nullptr;
+		uint32* backendPixels = nullptr; //Buffer from the backend, the same as pixels unless frames are presented asynchronously
+		uint32 width, height, startX, startY, consoleWidth, consoleHeight;
+		RenderMode renderMode;
+		std::unique_ptr<RenderBackend> defaultBackend;
+		RenderBackend* backend = nullptr;
+		bool alphaMode;
+		uint16 pixelSize;
+		bool enableShaders;
+		struct Shader
+		{
+			PixelShader pixelFunc;
+			SpanShader spanFunc;
+			void* data;
+			uint32 halo;
+		};
+		std::vector<Shader> shaderList;
+		std::vector<uint32> shaderHaloRows;
+		std::vector<int64> polygonPoints;
+		std::string title;
+		float outputScale = 1.f;
+		//Areas changed since the last display(), kept disjoint
+		static const uint32 maxDirtyRects = 8;
+		bool dirtyTracking;
+		std::vector<Rect> dirtyRects;
+		float redrawFraction;
+		//Asynchronous presenting, frame f is drawn into frameSlots[f % frameSlots.size()] and handed to the presenter thread by display()
+		struct FrameSlot
+		{
+			std::vector<uint32> pixels;
+			PresentInfo info;
+			std::vector<Rect> rects; //Dirty rects of the frame
+			std::vector<Shader> shaders; //Empty if shaders were disabled
+			std::vector<Rect> stale; //Changes made since this buffer was last drawn into
+			bool staleAll;
+		};
+		std::vector<FrameSlot> frameSlots;
+		std::thread presenterThread;
+		//Only the caller writes framesSubmitted and only the presenter writes framesPresented
+		std::atomic<uint64> framesSubmitted, framesPresented;
+		std::atomic<bool> callerWaiting, presenterWaiting, stopPresenter, lastPresentResult;
+		std::mutex presentMutex;
+		std::condition_variable presentWake;
+		//Recorded draw calls, see enableCommandBuffer()
+		enum class CommandType : uint8 {Image, ImageEX, Transformed, Rect, RectA, Line, LineAA, Circle, Convex, Pixel, PixelA, Span, Clear};
+		struct DrawCommand
+		{
+			CommandType type;
+			bool blend; //Alpha mode when the command was recorded
+			uint8 alpha, flags;
+			int32 layer;
+			uint32 left, top, right, bottom; //Bounding box clipped to the buffer
+			Image* image;
+			uint32 rgb;
+			uint32 a[6]; //Integer arguments
+			float v[6]; //Float arguments
+			void(*funcPtr)(std::pair<uint32, uint8>*, void*);
+			void* funcData;
+		};
+		bool recordCommands;
+		int32 commandLayer;
+		CommandSort commandSort;
+		uint32 culledCommands;
+		//Polygon points live in commandPoints, the last flushed list is kept for replayCommands()
+		std::vector<DrawCommand> commandList, replayList;
+		std::vector<int64> commandPoints, replayPoints;
+		uint32 replayCulled;
+		//Tiled rendering, see enableTiledRendering()
+		uint32 tileSize;
+		std::vector<std::vector<uint32>> tileBins;
+		std::vector<uint32> tileOrder;
+	protected:
+		void initialise(void)
+		{
+			renderMode = RenderMode::BitBlt;
+			startX = 0;
+			startY = 0;
+			pixelSize = 1;
+			outputScale = 1.f;
+
+			alphaMode = false;
+			enableShaders = false;
+			dirtyTracking = false;
+			redrawFraction = 1.f;
+			framesSubmitted = 0;
+			framesPresented = 0;
+			callerWaiting = false;
+			presenterWaiting = false;
+			stopPresenter = false;
+			lastPresentResult = true;
+			recordCommands = false;
+			commandLayer = 0;
+			commandSort = CommandSort::Layer;
+			culledCommands = 0;
+			replayCulled = 0;
+			tileSize = 0;
+
+			return;
+		}
+
+		void CreateDefaultBackend(void)
+		{
+		#ifdef CG_WINDOWS
+			defaultBackend.reset(new GDIBackend(GetDC(GetConsoleWindow())));
+		#else
+			defaultBackend.reset(new MemoryBackend());
+		#endif
+			return;
+		}
+
+	#ifdef CG_WINDOWS
+		//Improve this
+		void RemoveScrollbar(void)
+		{
+			ShowScrollBar(GetConsoleWindow(), SB_BOTH, FALSE);
+			return;
+		}
+
+		void GetWindowSize(HWND w, uint32& width, uint32& height)
+		{
+			RECT window;
+			GetWindowRect(w, &window);
+
+			width = window.right - window.left;
+			height = window.bottom - window.top;
+			return;
+		}
+
+		void SetConsoleSize(uint32 width, uint32 height)
+		{
+			RECT window;
+			GetWindowRect(GetConsoleWindow(), &window);
+			SetWindowPos(GetConsoleWindow(), HWND_TOP, window.left, window.top, width, height, SWP_SHOWWINDOW);
+			RemoveScrollbar();
+			return;
+		}
+	#endif
+
+		std::vector<uint32> ResizeDataNearestNeighbor(std::vector<uint32>& pixels, uint32 newWidth, uint32 newHeight)
+		{
+			std::vector<uint32> data, xTable, yTable;
+			float xScale = (float)width / (float)newWidth, yScale = (float)height / (float)newHeight;
+			data.resize(newWidth * newHeight);
+
+			buildIndexTable(xTable, newWidth, xScale, 0, width - 1);
+			buildIndexTable(yTable, newHeight, yScale, 0, height - 1);
+			scaleNearest(data.data(), newWidth, newHeight, pixels.data(), width, xTable.data(), yTable.data());
+
+			width = newWidth;
+			height = newHeight;
+			return data;
+		}
+
+		//drawEX() callbacks still take std::pair pixels
+		static void applyPixelFunc(Pixel& pixel, void(*funcPtr)(std::pair<uint32, uint8>*, void*), void* funcData)
+		{
+			std::pair<uint32, uint8> p = pixel;
+			funcPtr(&p, funcData);
+			pixel = p;
+			return;
+		}
+
+		//(Re)creates the buffer through the backend, the buffer is cleared
+		void CreateBuffer(uint32 width, uint32 height)
+		{
+			this->width = width;
+			this->height = height;
+			pixels = backend->createBuffer(width, height);
+			backendPixels = pixels;
+			memset(pixels, 0, width * height * sizeof(uint32));
+			dirtyRects.clear();
+			MarkDirty(0, 0, width, height);
+			return;
+		}
+
+		//Shades columns [x0, x1) of one row, "row" is the start of the row and doesn't have to point into the buffer
+		void ShadeRow(const Shader& shader, uint32* row, uint32 y, uint32 x0, uint32 x1)
+		{
+			if (shader.spanFunc != nullptr){shader.spanFunc(row + x0, x1 - x0, x0, y, width, height, shader.data);
+			}
+			else {
+				for (uint32 x = x0; x < x1; ++x)
+				{
+					shader.pixelFunc(&row[x], width, height, x, y, shader.data);
+				}
+			}
+			return;
+		}
+
+		//Runs every shader over one band of rows while it's in cache
+		//Without halos the band is shaded in place, otherwise it's copied with enough extra rows for every shader to read its neighbours
+		//Only columns [x0, x1) are shaded and written back
+		void ShadeBand(uint32* target, const std::vector<Shader>& shaders, uint32 y0, uint32 y1, uint32 x0, uint32 x1, uint32 totalHalo, const uint32* haloRows)
+		{
+			if (totalHalo == 0)
+			{
+				for (uint32 i = 0; i < shaders.size(); ++i)
+				{
+					for (uint32 y = y0; y < y1; ++y)
+					{
+						ShadeRow(shaders[i], &target[y * width], y, x0, x1);
+					}
+				}
+				return;
+			}
+
+			static thread_local std::vector<uint32> band, output, window;
+			const uint32 r0 = y0 - std::min(y0, totalHalo), r1 = std::min(y1 + totalHalo, height);
+			band.resize((r1 - r0) * width);
+			output.resize(band.size());
+			//Rows outside the band were copied before any band was shaded
+			memcpy(&band[0], haloRows, (y0 - r0) * width * sizeof(uint32));
+			memcpy(&band[(y0 - r0) * width], &target[y0 * width], (y1 - y0) * width * sizeof(uint32));
+			memcpy(&band[(y1 - r0) * width], haloRows + ((y0 - r0) * width), (r1 - y1) * width * sizeof(uint32));
+
+			uint32 remainingHalo = totalHalo;
+			for (uint32 i = 0; i < shaders.size(); ++i)
+			{
+				const Shader& shader = shaders[i];
+				remainingHalo -= shader.halo;
+				//Rows later shaders will read from
+				const uint32 s0 = std::max(r0, y0 - std::min(y0, remainingHalo)), s1 = std::min(r1, y1 + remainingHalo);
+
+				if (shader.halo == 0)
+				{
+					for (uint32 y = s0; y < s1; ++y)
+					{
+						ShadeRow(shader, &band[(y - r0) * width], y, x0, x1);
+					}
+					continue;
+				}
+
+				//Each row is shaded in a copy of its neighbourhood so every shader sees the previous shader's output
+				for (uint32 y = s0; y < s1; ++y)
+				{
+					const uint32 w0 = std::max(r0, y - std::min(y, shader.halo)), w1 = std::min(r1, y + shader.halo + 1);
+					window.assign(band.data() + ((w0 - r0) * width), band.data() + ((w1 - r0) * width));
+					ShadeRow(shader, &window[(y - w0) * width], y, x0, x1);
+					memcpy(&output[((y - r0) * width) + x0], &window[((y - w0) * width) + x0], (x1 - x0) * sizeof(uint32));
+				}
+				for (uint32 y = s0; y < s1; ++y)
+				{
+					memcpy(&band[((y - r0) * width) + x0], &output[((y - r0) * width) + x0], (x1 - x0) * sizeof(uint32));
+				}
+			}
+
+			for (uint32 y = y0; y < y1; ++y)
+			{
+				memcpy(&target[(y * width) + x0], &band[((y - r0) * width) + x0], (x1 - x0) * sizeof(uint32));
+			}
+			return;
+		}
+
+		//Runs every shader over one area of target in one pass, bands of rows are shaded in parallel
+		//Halo shaders read whatever is in the buffer around the area
+		void RunShaders(uint32* target, const std::vector<Shader>& shaders, const Rect& area)
+		{
+			uint32 totalHalo = 0;
+			for (uint32 i = 0; i < shaders.size(); ++i)
+			{
+				totalHalo += shaders[i].halo;
+			}
+			const uint32 bandHeight = std::max<uint32>(std::max<uint32>(16384 / std::max<uint32>(area.width, 1), 1), totalHalo * 4);
+			const uint32 bandCount = (area.height + bandHeight - 1) / bandHeight;
+			ThreadPool& pool = ThreadPool::getShared();
+
+			//Copy the rows around each band before any band changes them
+			if (totalHalo != 0)
+			{
+				shaderHaloRows.resize(bandCount * totalHalo * 2 * width);
+				pool.parallelFor(area.height, bandHeight, [&](uint32 begin, uint32 end)
+				{
+					uint32* haloRows = &shaderHaloRows[(begin / bandHeight) * totalHalo * 2 * width];
+					begin += area.y, end += area.y;
+					const uint32 r0 = begin - std::min(begin, totalHalo), r1 = std::min(end + totalHalo, height);
+					memcpy(haloRows, &target[r0 * width], (begin - r0) * width * sizeof(uint32));
+					memcpy(haloRows + ((begin - r0) * width), &target[end * width], (r1 - end) * width * sizeof(uint32));
+				});
+			}
+
+			pool.parallelFor(area.height, bandHeight, [&](uint32 begin, uint32 end)
+			{
+				ShadeBand(target, shaders, area.y + begin, area.y + end, area.x, area.right(), totalHalo, totalHalo != 0 ? &shaderHaloRows[(begin / bandHeight) * totalHalo * 2 * width] : nullptr);
+			});
+			return;
+		}
+
+		//Spins briefly, then sleeps until ready() is true, the other thread calls Notify() after changing what ready() reads
+		//The mutex is only taken to sleep, frames are handed over with the atomic counters
+		template <class Ready> void WaitFor(std::atomic<bool>& waiting, Ready ready)
+		{
+			for (uint32 i = 0; i < 64; ++i)
+			{
+				if (ready()){return;
+				}
+				std::this_thread::yield();
+			}
+			std::unique_lock<std::mutex> lock(presentMutex);
+			waiting = true;
+			presentWake.wait(lock, ready);
+			waiting = false;
+			return;
+		}
+		void Notify(std::atomic<bool>& waiting)
+		{
+			if (waiting)
+			{
+				std::lock_guard<std::mutex> lock(presentMutex);
+				presentWake.notify_all();
+			}
+			return;
+		}
+		//Copies the rows of rects (the whole buffer if rects is nullptr) from src to dst
+		void CopyRects(uint32* dst, const uint32* src, const Rect* rects, uint32 count)
+		{
+			if (rects == nullptr)
+			{
+				memcpy(dst, src, width * height * sizeof(uint32));
+				return;
+			}
+			for (uint32 i = 0; i < count; ++i)
+			{
+				for (uint32 y = rects[i].y; y < rects[i].bottom(); ++y)
+				{
+					memcpy(&dst[(y * width) + rects[i].x], &src[(y * width) + rects[i].x], rects[i].width * sizeof(uint32));
+				}
+			}
+			return;
+		}
+
+		//Presenter thread, frames are copied into the backend's buffer, shaded there and presented in order
+		void PresenterLoop(void)
+		{
+			static const Rect noRects;
+			uint64 frame = framesPresented;
+			while (true)
+			{
+				WaitFor(presenterWaiting, [&]{return stopPresenter || framesSubmitted > frame;});
+				//Frames that are already queued are presented before stopping
+				if (framesSubmitted == frame){return;
+				}
+
+				FrameSlot& slot = frameSlots[frame % frameSlots.size()];
+				PresentInfo info = slot.info;
+				const bool partial = info.dirtyRects != nullptr;
+				if (partial){info.dirtyRects = slot.rects.empty() ? &noRects : slot.rects.data();
+				}
+				CopyRects(backendPixels, slot.pixels.data(), info.dirtyRects, info.dirtyRectCount);
+				if (!slot.shaders.empty())
+				{
+					for (uint32 i = 0; i < (partial ? info.dirtyRectCount : 1); ++i)
+					{
+						RunShaders(backendPixels, slot.shaders, partial ? info.dirtyRects[i] : Rect(0, 0, width, height));
+					}
+				}
+				lastPresentResult = backend->present(backendPixels, info);
+
+				framesPresented = ++frame;
+				Notify(callerWaiting);
+			}
+		}
+		//Hands the current buffer to the presenter thread and moves on to the next one once the presenter is done with it
+		void SubmitFrame(const PresentInfo& info)
+		{
+			const uint64 frame = framesSubmitted;
+			const uint32 depth = frameSlots.size();
+			FrameSlot& current = frameSlots[frame % depth];
+			current.info = info;
+			current.rects.assign(dirtyRects.begin(), dirtyRects.end());
+			if (enableShaders){current.shaders = shaderList;
+			}
+			else current.shaders.clear();
+			//Every other buffer is now missing this frame's changes
+			for (uint32 i = 0; i < depth; ++i)
+			{
+				if (&frameSlots[i] == &current){continue;
+				}
+				if (info.dirtyRects == nullptr){frameSlots[i].staleAll = true;
+				}
+				else frameSlots[i].stale.insert(frameSlots[i].stale.end(), dirtyRects.begin(), dirtyRects.end());
+			}
+
+			//The next buffer was last drawn into by frame + 1 - depth
+			WaitFor(callerWaiting, [&]{return framesPresented + depth >= frame + 2;});
+			FrameSlot& next = frameSlots[(frame + 1) % depth];
+			if (next.staleAll){CopyRects(next.pixels.data(), current.pixels.data(), nullptr, 0);
+			}
+			else CopyRects(next.pixels.data(), current.pixels.data(), next.stale.data(), next.stale.size());
+			next.stale.clear();
+			next.staleAll = false;
+
+			framesSubmitted = frame + 1;
+			Notify(presenterWaiting);
+			pixels = next.pixels.data();
+			return;
+		}
+		//Presents the queued frames and stops the presenter thread
+		void StopPresenter(void)
+		{
+			if (frameSlots.empty()){return;
+			}
+			stopPresenter = true;
+			Notify(presenterWaiting);
+			presenterThread.join();
+			return;
+		}
+
+		static Rect UnionRect(const Rect& a, const Rect& b)
+		{
+			const uint32 x = std::min(a.x, b.x), y = std::min(a.y, b.y);
+			return Rect(x, y, std::max(a.right(), b.right()) - x, std::max(a.bottom(), b.bottom()) - y);
+		}
+		static bool Intersects(const Rect& a, const Rect& b)
+		{
+			return a.x < b.right() && b.x < a.right() && a.y < b.bottom() && b.y < a.bottom();
+		}
+		//Adds a rect to the dirty list, it absorbs every rect it overlaps or that would waste little area merged with it
+		void InsertDirtyRect(Rect rect)
+		{
+			for (uint32 i = 0; i < dirtyRects.size();)
+			{
+				const Rect merged = UnionRect(rect, dirtyRects[i]);
+				const uint64 areaSum = rect.area() + dirtyRects[i].area();
+				if (Intersects(rect, dirtyRects[i]) || merged.area() <= areaSum + (areaSum / 4))
+				{
+					//The merged rect can reach rects that were already checked
+					dirtyRects[i] = dirtyRects.back();
+					dirtyRects.pop_back();
+					rect = merged;
+					i = 0;
+				}
+				else ++i;
+			}
+			dirtyRects.push_back(rect);
+			return;
+		}
+		//Records that [left, right) x [top, bottom) changed, the area is clamped to the buffer
+		void MarkDirty(int64 left, int64 top, int64 right, int64 bottom)
+		{
+			if (!dirtyTracking){return;
+			}
+			left = std::max<int64>(left, 0), top = std::max<int64>(top, 0);
+			right = std::min<int64>(right, width), bottom = std::min<int64>(bottom, height);
+			if (left >= right || top >= bottom){return;
+			}
+			InsertDirtyRect(Rect(left, top, right - left, bottom - top));
+
+			//Too many rects, merge the pair that wastes the least area
+			while (dirtyRects.size() > maxDirtyRects)
+			{
+				uint32 bestA = 0, bestB = 1;
+				uint64 bestWaste = std::numeric_limits<uint64>::max();
+				for (uint32 a = 0; a < dirtyRects.size(); ++a)
+				{
+					for (uint32 b = a + 1; b < dirtyRects.size(); ++b)
+					{
+						const uint64 waste = UnionRect(dirtyRects[a], dirtyRects[b]).area() - dirtyRects[a].area() - dirtyRects[b].area();
+						if (waste < bestWaste)
+						{
+							bestWaste = waste;
+							bestA = a, bestB = b;
+						}
+					}
+				}
+				const Rect merged = UnionRect(dirtyRects[bestA], dirtyRects[bestB]);
+				dirtyRects.erase(dirtyRects.begin() + bestB);
+				dirtyRects.erase(dirtyRects.begin() + bestA);
+				InsertDirtyRect(merged);
+			}
+			return;
+		}
+		//floor() and ceil() limited to [-1, limit], huge values can't be converted to integers otherwise
+		static int64 ClampFloor(float v, float limit)
+		{
+			return (int64)floor(std::min<float>(std::max<float>(v, -1.f), limit));
+		}
+		static int64 ClampCeil(float v, float limit)
+		{
+			return (int64)ceil(std::min<float>(std::max<float>(v, -1.f), limit));
+		}
+		//Same as MarkDirty() for fractional bounds
+		void MarkDirtyF(float left, float top, float right, float bottom)
+		{
+			if (!dirtyTracking || !(left <= right) || !(top <= bottom)){return;
+			}
+			MarkDirty(ClampFloor(left, width + 1.f), ClampFloor(top, height + 1.f), ClampCeil(right, width + 1.f), ClampCeil(bottom, height + 1.f));
+			return;
+		}
+
+		//Records a command whose pixels are inside [left, right) x [top, bottom), returns nullptr if that's outside the buffer
+		DrawCommand* PushCommand(CommandType type, int64 left, int64 top, int64 right, int64 bottom)
+		{
+			left = std::max<int64>(left, 0), top = std::max<int64>(top, 0);
+			right = std::min<int64>(right, width), bottom = std::min<int64>(bottom, height);
+			if (left >= right || top >= bottom)
+			{
+				++culledCommands;
+				return nullptr;
+			}
+			commandList.emplace_back();
+			DrawCommand& command = commandList.back();
+			command.type = type;
+			command.blend = alphaMode;
+			command.alpha = 255;
+			command.flags = 0;
+			command.layer = commandLayer;
+			command.left = left, command.top = top, command.right = right, command.bottom = bottom;
+			command.image = nullptr;
+			command.rgb = 0;
+			command.funcPtr = nullptr;
+			command.funcData = nullptr;
+			return &command;
+		}
+		//Groups each run of consecutive image draws in a layer by image, images keep the order of their first draw in the run
+		//Any other command ends a run, so nothing is moved past it and the result doesn't depend on where the images are in memory
+		void GroupImageRuns(void)
+		{
+			std::vector<std::pair<const Image*, uint32>> byImage;
+			std::vector<std::pair<uint32, uint32>> order; //First draw of the image in the run, position in the run
+			std::vector<DrawCommand> run;
+			for (uint32 begin = 0; begin < commandList.size();)
+			{
+				uint32 end = begin;
+				while (end < commandList.size() && commandList[end].image != nullptr && commandList[end].layer == commandList[begin].layer){++end;
+				}
+				if (end - begin > 2)
+				{
+					byImage.clear();
+					for (uint32 i = begin; i < end; ++i)
+					{
+						byImage.push_back(std::make_pair(commandList[i].image, i - begin));
+					}
+					//Equal images end up next to each other with their first draw in front
+					std::sort(byImage.begin(), byImage.end(), [](const std::pair<const Image*, uint32>& a, const std::pair<const Image*, uint32>& b)
+					{
+						return a.first != b.first ? std::less<const Image*>()(a.first, b.first) : a.second < b.second;
+					});
+					order.resize(byImage.size());
+					for (uint32 i = 0; i < byImage.size(); ++i)
+					{
+						const uint32 first = i != 0 && byImage[i].first == byImage[i - 1].first ? order[i - 1].first : byImage[i].second;
+						order[i] = std::make_pair(first, byImage[i].second);
+					}
+					std::sort(order.begin(), order.end());
+
+					run.assign(commandList.begin() + begin, commandList.begin() + end);
+					for (uint32 i = 0; i < order.size(); ++i)
+					{
+						commandList[begin + i] = run[order[i].second];
+					}
+				}
+				begin = std::max(end, begin + 1);
+			}
+			return;
+		}
+		DrawCommand* PushCommandF(CommandType type, float left, float top, float right, float bottom)
+		{
+			if (!(left <= right) || !(top <= bottom))
+			{
+				++culledCommands;
+				return nullptr;
+			}
+			return PushCommand(type, ClampFloor(left, width + 1.f), ClampFloor(top, height + 1.f), ClampCeil(right, width + 1.f), ClampCeil(bottom, height + 1.f));
+		}
+		//Records a convex polygon given as fixed point points (see RasterConvex())
+		void PushConvex(const int64* points, uint32 count, uint32 rgb, uint8 alpha)
+		{
+			if (count < 3){return;
+			}
+			int64 minX = points[0], maxX = points[0], minY = points[1], maxY = points[1];
+			for (uint32 i = 1; i < count; ++i)
+			{
+				minX = std::min(minX, points[i * 2]), maxX = std::max(maxX, points[i * 2]);
+				minY = std::min(minY, points[(i * 2) + 1]), maxY = std::max(maxY, points[(i * 2) + 1]);
+			}
+			DrawCommand* command = PushCommand(CommandType::Convex, FloorDiv(minX, 256), FloorDiv(minY, 256), CeilDiv(maxX, 256) + 1, CeilDiv(maxY, 256) + 1);
+			if (command != nullptr)
+			{
+				command->a[0] = commandPoints.size();
+				command->a[1] = count;
+				command->rgb = rgb;
+				command->alpha = alpha;
+				commandPoints.insert(commandPoints.end(), points, points + (count * 2));
+			}
+			return;
+		}
+		//True if the command overwrites every pixel of the buffer, so nothing drawn before it can be seen
+		bool CoversBuffer(const DrawCommand& command) const
+		{
+			if (command.left != 0 || command.top != 0 || command.right != width || command.bottom != height){return false;
+			}
+			switch (command.type)
+			{
+				case CommandType::Clear:
+					return true;
+				case CommandType::Rect:
+					return command.flags != 0;
+				case CommandType::Image:
+					return !command.blend || command.image->isOpaque();
+				default:
+					return false;
+			}
+		}
+		//Fills (or blends if blend is set) [left, right) x [top, bottom) inside clip
+		void FillRect(int64 left, int64 top, int64 right, int64 bottom, uint32 rgb, uint8 alpha, bool blend, const Rect& clip)
+		{
+			left = std::max<int64>(left, clip.x), top = std::max<int64>(top, clip.y);
+			right = std::min<int64>(right, clip.right()), bottom = std::min<int64>(bottom, clip.bottom());
+			if (left >= right){return;
+			}
+			for (int64 y = top; y < bottom; ++y)
+			{
+				if (blend){blendSpan(&pixels[(y * width) + left], rgb, alpha, (uint32)(right - left));
+				}
+				else fillSpan(&pixels[(y * width) + left], rgb, (uint32)(right - left));
+			}
+			return;
+		}
+		//The four one pixel edges of drawRect(x, y, w, h, rgb, false) inside clip, the right and bottom edges are at x + w and y + h
+		void OutlineRect(int64 x, int64 y, int64 w, int64 h, uint32 rgb, const Rect& clip)
+		{
+			FillRect(x, y, x + w, y + 1, rgb, 255, false, clip);
+			FillRect(x + w, y, x + w + 1, y + h, rgb, 255, false, clip);
+			FillRect(x + 1, y + h, x + w + 1, y + h + 1, rgb, 255, false, clip);
+			FillRect(x, y + 1, x + 1, y + h + 1, rgb, 255, false, clip);
+			return;
+		}
+		//Draws the part of a recorded command inside clip, the result is the same as the draw call it was recorded from
+		//Doesn't mark dirty rectangles, so it can run on several threads at once for clips that don't overlap
+		void ExecuteCommand(const DrawCommand& c, const std::vector<int64>& points, const Rect& clip)
+		{
+			switch (c.type)
+			{
+				case CommandType::Image:
+					DrawImage(*c.image, (int32)c.a[0], (int32)c.a[1], c.blend, clip);
+					break;
+				case CommandType::ImageEX:
+					DrawImageEX(*c.image, c.a[0], c.a[1], (int32)c.a[2], (int32)c.a[3], c.a[4], c.a[5], (DrawType)c.flags, c.funcPtr, c.funcData, c.blend, clip);
+					break;
+				case CommandType::Transformed:
+				{
+					AffineTransform transform;
+					transform.a = c.v[0], transform.b = c.v[1], transform.c = c.v[2];
+					transform.d = c.v[3], transform.e = c.v[4], transform.f = c.v[5];
+					DrawTransformed(*c.image, transform, (InterpolationMethod)c.flags, c.blend, clip);
+				}
+				break;
+				case CommandType::Rect:
+				{
+					const int64 x = c.a[0], y = c.a[1], w = c.a[2], h = c.a[3];
+					if (c.flags != 0){FillRect(x, y, x + w, y + h, c.rgb, 255, false, clip);
+					}
+					else OutlineRect(x, y, w, h, c.rgb, clip);
+				}
+				break;
+				case CommandType::RectA:
+					FillRect(c.a[0], c.a[1], (int64)c.a[0] + c.a[2], (int64)c.a[1] + c.a[3], c.rgb, c.alpha, true, clip);
+					break;
+				case CommandType::Line:
+					RasterLine((int32)c.a[0], (int32)c.a[1], (int32)c.a[2], (int32)c.a[3], c.rgb, c.alpha, clip);
+					break;
+				case CommandType::LineAA:
+					RasterLineAA(c.v[0], c.v[1], c.v[2], c.v[3], c.rgb, c.alpha, clip);
+					break;
+				case CommandType::Circle:
+					RasterCircleAA(c.v[0], c.v[1], c.v[2], c.rgb, c.flags != 0, c.alpha, clip);
+					break;
+				case CommandType::Convex:
+					RasterConvex(&points[c.a[0]], c.a[1], c.rgb, c.alpha, clip);
+					break;
+				case CommandType::Pixel:
+				case CommandType::PixelA:
+					if (OutCode(c.a[0], c.a[1], clip) == 0)
+					{
+						uint32& pixel = pixels[(c.a[1] * width) + c.a[0]];
+						if (c.type == CommandType::Pixel){pixel = c.rgb;
+						}
+						else if (c.blend){pixel = blendPixel(pixel, c.rgb, c.alpha);
+						}
+					}
+					break;
+				case CommandType::Span:
+				{
+					//Backward spans end at (x, y)
+					const bool forward = (c.flags & 1) != 0;
+					const int64 start = (c.flags & 2) ? c.a[1] : c.a[0], first = forward ? start : start - c.a[2] + 1, last = forward ? start + c.a[2] : start + 1;
+					if (c.flags & 2){FillRect(c.a[0], first, (int64)c.a[0] + 1, last, c.rgb, 255, false, clip);
+					}
+					else FillRect(first, c.a[1], last, (int64)c.a[1] + 1, c.rgb, 255, false, clip);
+				}
+				break;
+				case CommandType::Clear:
+					FillRect(0, 0, width, height, c.rgb * 0x01010101, 255, false, clip);
+					break;
+			}
+			return;
+		}
+		//Draws commands [first, commands.size()) tile by tile, each tile draws its commands in order and tiles run in parallel on the shared thread pool
+		void ExecuteTiled(const std::vector<DrawCommand>& commands, const std::vector<int64>& points, uint32 first)
+		{
+			//Each command goes in the bin of every tile its bounding box touches
+			const uint32 tilesX = (width + tileSize - 1) / tileSize, tilesY = (height + tileSize - 1) / tileSize;
+			tileBins.resize(tilesX * tilesY);
+			for (uint32 i = 0; i < tileBins.size(); ++i)
+			{
+				tileBins[i].clear();
+			}
+			for (uint32 i = first; i < commands.size(); ++i)
+			{
+				const DrawCommand& c = commands[i];
+				for (uint32 ty = c.top / tileSize; ty <= (c.bottom - 1) / tileSize; ++ty)
+				{
+					for (uint32 tx = c.left / tileSize; tx <= (c.right - 1) / tileSize; ++tx)
+					{
+						tileBins[(ty * tilesX) + tx].push_back(i);
+					}
+				}
+			}
+
+			//Busiest tiles go first so a thread isn't left with one big tile at the end
+			tileOrder.clear();
+			for (uint32 i = 0; i < tileBins.size(); ++i)
+			{
+				if (!tileBins[i].empty()){tileOrder.push_back(i);
+				}
+			}
+			std::stable_sort(tileOrder.begin(), tileOrder.end(), [&](uint32 a, uint32 b){return tileBins[a].size() > tileBins[b].size();});
+
+			//Threads take the next tile as they finish one, so uneven tiles balance out
+			ThreadPool::getShared().parallelFor(tileOrder.size(), 1, [&](uint32 begin, uint32 end)
+			{
+				for (uint32 i = begin; i < end; ++i)
+				{
+					const uint32 tile = tileOrder[i], x = (tile % tilesX) * tileSize, y = (tile / tilesX) * tileSize;
+					const Rect clip(x, y, std::min(tileSize, width - x), std::min(tileSize, height - y));
+					const std::vector<uint32>& bin = tileBins[tile];
+					for (uint32 j = 0; j < bin.size(); ++j)
+					{
+						ExecuteCommand(commands[bin[j]], points, clip);
+					}
+				}
+			});
+			return;
+		}
+		//Draws a list of recorded commands in order, each with the alpha mode it was recorded with
+		//tiled = false draws on the calling thread, otherwise the buffer is split into tiles (see enableTiledRendering())
+		CommandStats ExecuteCommands(const std::vector<DrawCommand>& commands, const std::vector<int64>& points, uint32 culled, bool tiled)
+		{
+			CommandStats stats;
+			stats.commands = commands.size() + culled;
+
+			//Everything before the last command that covers the whole buffer is hidden
+			uint32 first = 0;
+			for (uint32 i = commands.size(); i-- > 0;)
+			{
+				if (CoversBuffer(commands[i]))
+				{
+					first = i;
+					break;
+				}
+			}
+			stats.culled = culled + first;
+
+			//Dirty rectangles and the images' cached flags and mip levels are filled in here, so drawing doesn't change anything shared
+			for (uint32 i = first; i < commands.size(); ++i)
+			{
+				const DrawCommand& c = commands[i];
+				if (i == first || c.type != commands[i - 1].type || c.image != commands[i - 1].image){++stats.batches;
+				}
+				MarkDirty(c.left, c.top, c.right, c.bottom);
+				if (c.image != nullptr)
+				{
+					c.image->isOpaque();
+					c.image->isFullyTransparent();
+					c.image->getMipLevelCount();
+				}
+			}
+			const bool wasTracking = dirtyTracking;
+			dirtyTracking = false;
+			if (tiled){ExecuteTiled(commands, points, first);
+			}
+			else {
+				const Rect clip = BufferRect();
+				for (uint32 i = first; i < commands.size(); ++i)
+				{
+					ExecuteCommand(commands[i], points, clip);
+				}
+			}
+			dirtyTracking = wasTracking;
+			return stats;
+		}
+		//True if flushed commands are drawn in tiles
+		bool UseTiles(void) const
+		{
+			return tileSize != 0 && ThreadPool::getShared().getThreadCount() > 1;
+		}
+
+		//Cohen-Sutherland region code of a point, 0 means the point is inside clip
+		static uint8 OutCode(int64 x, int64 y, const Rect& clip)
+		{
+			return (x < (int64)clip.x ? 1 : 0) | (x >= (int64)clip.right() ? 2 : 0) | (y < (int64)clip.y ? 4 : 0) | (y >= (int64)clip.bottom() ? 8 : 0);
+		}
+		Rect BufferRect(void) const
+		{
+			return Rect(0, 0, width, height);
+		}
+		static int64 FloorDiv(int64 a, int64 b)
+		{
+			return a >= 0 ? a / b : -((b - 1 - a) / b);
+		}
+		static int64 CeilDiv(int64 a, int64 b)
+		{
+			return -FloorDiv(-a, b);
+		}
+		//floor(((2 * i * m) + n) / (2 * n)) and its remainder, i * m is divided by n first so it doesn't overflow for any int32 line
+		static int64 LineMinor(int64 i, int64 m, int64 n, int64& remainder)
+		{
+			const uint64 product = (uint64)i * (uint64)m;
+			remainder = (2 * (int64)(product % n)) + n;
+			if (remainder >= 2 * n)
+			{
+				remainder -= 2 * n;
+				return (int64)(product / n) + 1;
+			}
+			return (int64)(product / n);
+		}
+
+		template <bool Blend> static void StepLine(uint32* dst, int64 count, int64 remainder, int64 minorStep, int64 errorLimit, ptrdiff_t majorOffset, ptrdiff_t minorOffset, uint32 rgb, uint8 alpha)
+		{
+			ptrdiff_t index = 0;
+			for (int64 i = 0; i < count; ++i)
+			{
+				if (Blend){dst[index] = blendPixel(dst[index], rgb, alpha);
+				}
+				else dst[index] = rgb;
+				remainder += minorStep;
+				if (remainder >= errorLimit)
+				{
+					remainder -= errorLimit;
+					index += minorOffset;
+				}
+				index += majorOffset;
+			}
+			return;
+		}
+
+		//Integer line from (x0, y0) to (x1, y1), both end points are drawn
+		//The line is clipped to clip (which has to be inside the buffer) before drawing, the visible pixels are the same ones the unclipped line would draw
+		void RasterLine(int32 x0, int32 y0, int32 x1, int32 y1, uint32 rgb, uint8 alpha, const Rect& clip)
+		{
+			const uint8 code0 = OutCode(x0, y0, clip), code1 = OutCode(x1, y1, clip);
+			if (alpha == 0 || (code0 & code1) != 0){return;
+			}
+			MarkDirty(std::min(x0, x1), std::min(y0, y1), (int64)std::max(x0, x1) + 1, (int64)std::max(y0, y1) + 1);
+
+			const int64 dx = (int64)x1 - x0, dy = (int64)y1 - y0;
+			const bool steep = std::abs(dy) > std::abs(dx);
+			const int64 major0 = steep ? y0 : x0, minor0 = steep ? x0 : y0;
+			const int64 majorSign = (steep ? dy : dx) < 0 ? -1 : 1, minorSign = (steep ? dx : dy) < 0 ? -1 : 1;
+			//Pixels are drawn where low <= coordinate < high
+			const int64 majorLow = steep ? clip.y : clip.x, majorHigh = steep ? clip.bottom() : clip.right();
+			const int64 minorLow = steep ? clip.x : clip.y, minorHigh = steep ? clip.right() : clip.bottom();
+			const int64 n = std::abs(steep ? dy : dx), m = std::abs(steep ? dx : dy);
+
+			if (n == 0)
+			{
+				if (code0 == 0){accessBuffer(x0, y0) = alpha == 255 ? rgb : blendPixel(accessBuffer(x0, y0), rgb, alpha);
+				}
+				return;
+			}
+			//Step i draws the pixel at major0 + (i * majorSign), minor0 + (minorSign * floor(((2 * i * m) + n) / (2 * n)))
+			//Clipping finds the range of steps that land inside clip (Liang-Barsky on the integer line)
+			int64 first = 0, last = n;
+			if ((code0 | code1) != 0)
+			{
+				if (majorSign > 0)
+				{
+					first = std::max(first, majorLow - major0);
+					last = std::min(last, majorHigh - 1 - major0);
+				}
+				else {
+					first = std::max(first, major0 - (majorHigh - 1));
+					last = std::min(last, major0 - majorLow);
+				}
+
+				//Allowed range of floor(((2 * i * m) + n) / (2 * n)), it never leaves [0, m]
+				const int64 low = std::max<int64>(minorSign > 0 ? minorLow - minor0 : minor0 - (minorHigh - 1), 0);
+				const int64 high = std::min<int64>(minorSign > 0 ? minorHigh - 1 - minor0 : minor0 - minorLow, m);
+				if (low > high){return;
+				}
+				if (m != 0)
+				{
+					//CeilDiv((2 * n * low) - n, 2 * m) and FloorDiv((2 * n * (high + 1)) - n - 1, 2 * m), with the products divided by m first since they can need 65 bits
+					const uint64 lowProduct = (uint64)n * (uint64)low, highProduct = (uint64)n * (uint64)(high + 1);
+					first = std::max(first, (int64)(lowProduct / m) + CeilDiv((2 * (int64)(lowProduct % m)) - n, 2 * m));
+					last = std::min(last, (int64)(highProduct / m) + FloorDiv((2 * (int64)(highProduct % m)) - n - 1, 2 * m));
+				}
+				if (first > last){return;
+				}
+			}
+
+			int64 remainder;
+			const int64 majorStart = major0 + (majorSign * first), minorStart = minor0 + (minorSign * LineMinor(first, m, n, remainder));
+			const int64 x = steep ? minorStart : majorStart, y = steep ? majorStart : minorStart;
+			uint32* dst = &pixels[(y * width) + x];
+			const int64 count = last - first + 1;
+
+			if (m == 0 && !steep)
+			{
+				//Horizontal lines are one span
+				if (majorSign < 0){dst -= count - 1;
+				}
+				if (alpha == 255){fillSpan(dst, rgb, (uint32)count);
+				}
+				else blendSpan(dst, rgb, alpha, (uint32)count);
+			}
+			else {
+				const ptrdiff_t rowStep = (ptrdiff_t)width;
+				const ptrdiff_t majorOffset = steep ? majorSign * rowStep : majorSign, minorOffset = steep ? minorSign : minorSign * rowStep;
+				if (alpha == 255){StepLine<false>(dst, count, remainder, 2 * m, 2 * n, majorOffset, minorOffset, rgb, alpha);
+				}
+				else StepLine<true>(dst, count, remainder, 2 * m, 2 * n, majorOffset, minorOffset, rgb, alpha);
+			}
+			return;
+		}
+
+		//Blends rgb into one pixel with coverage out of 256, pixels outside of clip are skipped
+		void PlotCoverage(int64 x, int64 y, uint32 coverage, uint32 rgb, uint8 alpha, const Rect& clip)
+		{
+			//Same blend as the unclipped pixels of RasterLineAA(), so pixels come out the same whichever path draws them
+			if ((uint64)(x - clip.x) < clip.width && (uint64)(y - clip.y) < clip.height)
+			{
+				uint32& dst = pixels[(y * width) + x];
+				dst = blendPixel(dst, rgb, (uint8)((coverage * alpha) >> 8));
+			}
+			return;
+		}
+
+		//Xiaolin Wu's line in 16.16 fixed point, pixel centres are at integer coordinates
+		//The end pixels get partial coverage so joined lines don't leave a heavy dot where they meet
+		//Only the part next to the buffer is rasterised, pixels outside clip are skipped
+		void RasterLineAA(float x0, float y0, float x1, float y1, uint32 rgb, uint8 alpha, const Rect& clip)
+		{
+			if (alpha == 0){return;
+			}
+			MarkDirtyF(std::min(x0, x1) - 1.f, std::min(y0, y1) - 1.f, std::max(x0, x1) + 2.f, std::max(y0, y1) + 2.f);
+			const bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
+			if (steep)
+			{
+				std::swap(x0, y0);
+				std::swap(x1, y1);
+			}
+			if (x0 > x1)
+			{
+				std::swap(x0, x1);
+				std::swap(y0, y1);
+			}
+			//The line is cut against the buffer, not clip, so every clip rasterises exactly the same line
+			const int64 majorLimit = steep ? height : width;
+			const int64 majorLow = steep ? clip.y : clip.x, majorHigh = steep ? clip.bottom() : clip.right();
+			const int64 minorLow = steep ? clip.x : clip.y, minorHigh = steep ? clip.right() : clip.bottom();
+			if (x1 < -1.f || x0 > (float)majorLimit){return;
+			}
+			//Only the part next to the buffer can be seen, cutting the rest keeps the fixed point values small
+			if (x0 < -2.f || x1 > majorLimit + 1.f)
+			{
+				const double gradient = (double)(y1 - y0) / (double)(x1 - x0);
+				const double nx0 = std::max<double>(x0, -2.0), nx1 = std::min<double>(x1, majorLimit + 1.0);
+				y1 = (float)(y0 + ((nx1 - x0) * gradient));
+				y0 = (float)(y0 + ((nx0 - x0) * gradient));
+				x0 = (float)nx0;
+				x1 = (float)nx1;
+			}
+			if ((y0 < -1e9f && y1 < -1e9f) || (y0 > 1e9f && y1 > 1e9f)){return;
+			}
+
+			auto plot = [&](int64 major, int64 minor, uint32 coverage)
+			{
+				if (steep){PlotCoverage(minor, major, coverage, rgb, alpha, clip);
+				}
+				else PlotCoverage(major, minor, coverage, rgb, alpha, clip);
+			};
+
+			const float dx = x1 - x0;
+			const int64 gradient = dx < 1.f / 65536.f ? 65536 : (int64)floor((((double)y1 - y0) / dx) * 65536.0);
+			const int64 fx0 = (int64)floor((x0 * 65536.0) + 0.5), fy0 = (int64)floor((y0 * 65536.0) + 0.5);
+			const int64 fx1 = (int64)floor((x1 * 65536.0) + 0.5), fy1 = (int64)floor((y1 * 65536.0) + 0.5);
+
+			//End points, gap is how much of the end pixel the line covers along the major axis
+			const int64 xEnd0 = (fx0 + 32768) >> 16, xEnd1 = (fx1 + 32768) >> 16;
+			const int64 yEnd0 = fy0 + (((((xEnd0 * 65536) - fx0) * gradient)) >> 16);
+			const int64 yEnd1 = fy1 + (((((xEnd1 * 65536) - fx1) * gradient)) >> 16);
+			const uint32 gap0 = (uint32)(65536 - ((fx0 + 32768) & 0xFFFF)) >> 8, gap1 = (uint32)((fx1 + 32768) & 0xFFFF) >> 8;
+			const uint32 frac0 = (uint32)(yEnd0 & 0xFFFF) >> 8, frac1 = (uint32)(yEnd1 & 0xFFFF) >> 8;
+			if (xEnd0 == xEnd1)
+			{
+				const uint32 gap = (uint32)(fx1 - fx0) >> 8;
+				plot(xEnd0, yEnd0 >> 16, ((256 - frac0) * gap) >> 8);
+				plot(xEnd0, (yEnd0 >> 16) + 1, (frac0 * gap) >> 8);
+				return;
+			}
+			plot(xEnd0, yEnd0 >> 16, ((256 - frac0) * gap0) >> 8);
+			plot(xEnd0, (yEnd0 >> 16) + 1, (frac0 * gap0) >> 8);
+			plot(xEnd1, yEnd1 >> 16, ((256 - frac1) * gap1) >> 8);
+			plot(xEnd1, (yEnd1 >> 16) + 1, (frac1 * gap1) >> 8);
+
+			//Steps of the inner pixels where floor(intery) is in [minFloor, maxFloor] and the major axis is in clip
+			const int64 yStart = yEnd0 + gradient;
+			auto stepRange = [&](int64 minFloor, int64 maxFloor, int64& first, int64& last)
+			{
+				first = std::max<int64>(xEnd0 + 1, majorLow);
+				last = std::min<int64>(xEnd1 - 1, majorHigh - 1);
+				const int64 low = (minFloor * 65536) - yStart, high = ((maxFloor + 1) * 65536) - 1 - yStart;
+				if (gradient > 0)
+				{
+					first = std::max(first, xEnd0 + 1 + CeilDiv(low, gradient));
+					last = std::min(last, xEnd0 + 1 + FloorDiv(high, gradient));
+				}
+				else if (gradient < 0)
+				{
+					first = std::max(first, xEnd0 + 1 + CeilDiv(-high, -gradient));
+					last = std::min(last, xEnd0 + 1 + FloorDiv(-low, -gradient));
+				}
+				else if (low > 0 || high < 0){last = first - 1;
+				}
+			};
+			int64 first, last, safeFirst, safeLast;
+			stepRange(minorLow - 1, minorHigh - 1, first, last);
+			//Both pixels of the pair are in clip between safeFirst and safeLast
+			stepRange(minorLow, minorHigh - 2, safeFirst, safeLast);
+			if (safeFirst > safeLast){safeFirst = last + 1, safeLast = last;
+			}
+
+			int64 intery = yStart + ((first - (xEnd0 + 1)) * gradient);
+			for (int64 x = first; x < safeFirst; ++x, intery += gradient)
+			{
+				const uint32 frac = (uint32)(intery & 0xFFFF) >> 8;
+				plot(x, intery >> 16, 256 - frac);
+				plot(x, (intery >> 16) + 1, frac);
+			}
+			const ptrdiff_t majorStride = steep ? width : 1, minorStride = steep ? 1 : width;
+			for (int64 x = safeFirst; x <= safeLast; ++x, intery += gradient)
+			{
+				const uint32 frac = (uint32)(intery & 0xFFFF) >> 8;
+				uint32* dst = &pixels[(x * majorStride) + ((intery >> 16) * minorStride)];
+				dst[0] = blendPixel(dst[0], rgb, (uint8)(((256 - frac) * alpha) >> 8));
+				dst[minorStride] = blendPixel(dst[minorStride], rgb, (uint8)((frac * alpha) >> 8));
+			}
+			for (int64 x = std::max(safeLast + 1, first); x <= last; ++x, intery += gradient)
+			{
+				const uint32 frac = (uint32)(intery & 0xFFFF) >> 8;
+				plot(x, intery >> 16, 256 - frac);
+				plot(x, (intery >> 16) + 1, frac);
+			}
+			return;
+		}
+
+		//Anti-aliased circle in 24.8 fixed point, the edge coverage uses d - r = (d^2 - r^2) / (d + r) with d + r ~ 2r + (d^2 - r^2) / 2r
+		//Edge pixels of a row are collected in a row buffer and blended with the vectorised row blend, only pixels inside clip are drawn
+		void RasterCircleAA(float cx, float cy, float radius, uint32 rgb, bool fill, uint8 alpha, const Rect& clip)
+		{
+			if (alpha == 0 || !(radius > 0.f) || clip.width == 0 || clip.height == 0){return;
+			}
+			const float outer = radius + (fill ? 0.5f : 1.f), inner = radius - (fill ? 0.5f : 1.f);
+			const int64 fcx = (int64)floor((cx * 256.f) + 0.5f), fcy = (int64)floor((cy * 256.f) + 0.5f), fr = std::max<int64>((int64)floor((radius * 256.f) + 0.5f), 1);
+			const int64 r2 = fr * fr;
+			const int64 y0 = std::max<int64>(ClampCeil(cy - outer, height + 1.f), clip.y), y1 = std::min<int64>(ClampFloor(cy + outer, height + 1.f), (int64)clip.bottom() - 1);
+			MarkDirtyF(cx - outer - 1.f, cy - outer - 1.f, cx + outer + 1.f, cy + outer + 1.f);
+			//Tiles can be drawn on several threads at once, so each thread has its own row buffer
+			static thread_local std::vector<Pixel> rowBuffer;
+			if (rowBuffer.size() < clip.width){rowBuffer.resize(clip.width);
+			}
+
+			auto edge = [&](uint32* row, int64 dy2, int64 begin, int64 end)
+			{
+				if (begin > end){return;
+				}
+				for (int64 x = begin; x <= end; ++x)
+				{
+					const int64 dx = (x << 8) - fcx;
+					const int64 difference = ((dx * dx) + dy2) - r2;
+					const int64 t = difference / ((2 * fr) + (difference / (2 * fr)));
+					const int64 coverage = fill ? 128 - t : 256 - std::abs(t);
+					rowBuffer[x - begin].first = rgb;
+					rowBuffer[x - begin].second = (uint8)((std::min<int64>(std::max<int64>(coverage, 0), 256) * alpha) >> 8);
+				}
+				blendRow(row + begin, rowBuffer.data(), (uint32)(end - begin + 1));
+			};
+
+			for (int64 y = y0; y <= y1; ++y)
+			{
+				const float dy = y - cy;
+				const float outerSpan = sqrtf(std::max((outer * outer) - (dy * dy), 0.f));
+				const int64 xa = std::max<int64>((int64)ceil(cx - outerSpan), clip.x), xb = std::min<int64>((int64)floor(cx + outerSpan), (int64)clip.right() - 1);
+				if (xa > xb){continue;
+				}
+				const int64 fdy = (y << 8) - fcy, dy2 = fdy * fdy;
+				uint32* row = &pixels[y * width];
+
+				//Pixels strictly inside the inner circle are fully covered (fill) or not covered (outline)
+				if (inner > 0.f && std::abs(dy) < inner)
+				{
+					const float innerSpan = sqrtf((inner * inner) - (dy * dy));
+					const int64 ia = std::max<int64>((int64)ceil(cx - innerSpan) + 1, xa), ib = std::min<int64>((int64)floor(cx + innerSpan) - 1, xb);
+					if (ia <= ib)
+					{
+						edge(row, dy2, xa, ia - 1);
+						edge(row, dy2, ib + 1, xb);
+						if (fill && alpha == 255){fillSpan(row + ia, rgb, (uint32)(ib - ia + 1));
+						}
+						else if (fill){blendSpan(row + ia, rgb, alpha, (uint32)(ib - ia + 1));
+						}
+						continue;
+					}
+				}
+				edge(row, dy2, xa, xb);
+			}
+			return;
+		}
+
+		//Polygon coordinates are 24.8 fixed point, clamped so the edge maths below fits in 64 bits
+		static int64 ToFixed8(float v)
+		{
+			return (int64)floor((std::min(std::max(v, -4194304.f), 4194304.f) * 256.f) + 0.5f);
+		}
+
+		//Fills a convex polygon given as count fixed point x, y pairs, in either winding order
+		//A pixel is filled when its centre (x + 0.5, y + 0.5) is inside. Centres on a top or left edge are inside
+		//and centres on a bottom or right edge are not (top-left rule), so polygons sharing an edge never overlap
+		void RasterConvex(const int64* points, uint32 count, uint32 rgb, uint8 alpha, const Rect& clip)
+		{
+			if (alpha == 0 || count < 3 || clip.width == 0 || clip.height == 0){return;
+			}
+			int64 minX = points[0], maxX = points[0], minY = points[1], maxY = points[1];
+			for (uint32 i = 1; i < count; ++i)
+			{
+				minX = std::min(minX, points[i * 2]);
+				maxX = std::max(maxX, points[i * 2]);
+				minY = std::min(minY, points[(i * 2) + 1]);
+				maxY = std::max(maxY, points[(i * 2) + 1]);
+			}
+			//Rows whose centre is in [minY, maxY)
+			const int64 firstRow = std::max<int64>(CeilDiv(minY - 128, 256), clip.y), lastRow = std::min<int64>(CeilDiv(maxY - 128, 256) - 1, (int64)clip.bottom() - 1);
+			MarkDirty(FloorDiv(minX, 256), firstRow, CeilDiv(maxX, 256), lastRow + 1);
+
+			for (int64 y = firstRow; y <= lastRow; ++y)
+			{
+				const int64 centreY = (y * 256) + 128;
+				int64 left = std::numeric_limits<int64>::max(), right = std::numeric_limits<int64>::min();
+				for (uint32 i = 0; i < count; ++i)
+				{
+					const int64* a = &points[i * 2];
+					const int64* b = &points[((i + 1) % count) * 2];
+					if (a[1] > b[1]){std::swap(a, b);
+					}
+					if (centreY < a[1] || centreY >= b[1]){continue;
+					}
+					//First column whose centre is right of or on the edge
+					const int64 dy = b[1] - a[1];
+					const int64 column = CeilDiv((a[0] * dy) + ((centreY - a[1]) * (b[0] - a[0])) - (128 * dy), 256 * dy);
+					left = std::min(left, column);
+					right = std::max(right, column);
+				}
+				left = std::max<int64>(left, clip.x);
+				right = std::min<int64>(right, clip.right());
+				if (left >= right){continue;
+				}
+
+				uint32* row = &pixels[(y * width) + left];
+				if (alpha == 255){fillSpan(row, rgb, (uint32)(right - left));
+				}
+				else blendSpan(row, rgb, alpha, (uint32)(right - left));
+			}
+			return;
+		}
+
+		//Limits the steps k so start + (k * step) stays in [0, limit]
+		static void ClipSteps(int64 start, int64 step, int64 limit, int64& first, int64& last)
+		{
+			if (step > 0)
+			{
+				first = std::max(first, CeilDiv(-start, step));
+				last = std::min(last, FloorDiv(limit - start, step));
+			}
+			else if (step < 0)
+			{
+				first = std::max(first, CeilDiv(start - limit, -step));
+				last = std::min(last, FloorDiv(start, -step));
+			}
+			else if (start < 0 || start > limit){last = first - 1;
+			}
+			return;
+		}
+		static int64 ToFixed16(double v)
+		{
+			return (int64)floor((std::min(std::max(v, -1e12), 1e12) * 65536.0) + 0.5);
+		}
+		//Mixes two 0xAARRGGBB colours, f is the weight of q out of 256
+		static uint32 LerpARGB(uint32 p, uint32 q, uint32 f)
+		{
+			const uint32 rb = ((((p & 0x00FF00FF) * (256 - f)) + ((q & 0x00FF00FF) * f)) >> 8) & 0x00FF00FF;
+			const uint32 ag = (((((p >> 8) & 0x00FF00FF) * (256 - f)) + (((q >> 8) & 0x00FF00FF) * f)) >> 8) & 0x00FF00FF;
+			return rb | (ag << 8);
+		}
+		//Copies or blends a row of image pixels into the buffer
+		//Copies are straight memcpys, the buffer's top byte is unused so the image's alpha can land there
+		//blend is the alpha mode to draw with
+		void DrawRow(uint32* dst, const Pixel* src, uint32 count, bool blend, bool premultiplied = false, bool opaque = false)
+		{
+			if (!blend || opaque){memcpy(dst, src, count * sizeof(Pixel));
+			}
+			else if (premultiplied){blendRowPremultiplied(dst, src, count);
+			}
+			else blendRow(dst, src, count);
+			return;
+		}
+		//Draws image at (posX, posY), only the part inside clip is drawn
+		void DrawImage(Image& image, int64 posX, int64 posY, bool blend, const Rect& clip)
+		{
+			//The image rectangle is intersected with clip once, then each row is a memcpy (opaque image or alpha off) or a row blend
+			const int64 left = std::max<int64>(posX, clip.x), top = std::max<int64>(posY, clip.y);
+			const int64 right = std::min<int64>(posX + image.getWidth(), clip.right()), bottom = std::min<int64>(posY + image.getHeight(), clip.bottom());
+			if (left >= right || top >= bottom){return;
+			}
+			if (blend && image.isFullyTransparent()){return;
+			}
+			const uint32 drawWidth = right - left, drawHeight = bottom - top;
+			const Pixel* src = &image.getPixelData()[((top - posY) * image.getWidth()) + (left - posX)];
+			const bool premultiplied = image.isPremultiplied(), opaque = image.isOpaque();
+			MarkDirty(left, top, right, bottom);
+
+			for (uint32 y = 0; y < drawHeight; ++y)
+			{
+				DrawRow(&pixels[((y + top) * width) + left], &src[y * image.getWidth()], drawWidth, blend, premultiplied, opaque);
+			}
+			return;
+		}
+		//Fills a convex polygon now or records it
+		void DrawConvex(const int64* points, uint32 count, uint32 rgb, uint8 alpha)
+		{
+			if (recordCommands){PushConvex(points, count, rgb, alpha);
+			}
+			else RasterConvex(points, count, rgb, alpha, BufferRect());
+			return;
+		}
+		//drawEX() limited to clip
+		void DrawImageEX(Image& image, uint32 srcX, uint32 srcY, int32 dstX, int32 dstY, uint32 width, uint32 height, DrawType drawType, void(*funcPtr)(std::pair<uint32, uint8>*, void*), void* funcData, bool blend, const Rect& clip)
+		{
+			const int64 left = std::max<int64>(dstX, clip.x), top = std::max<int64>(dstY, clip.y);
+			const int64 right = std::min<int64>((int64)dstX + width, clip.right()), bottom = std::min<int64>((int64)dstY + height, clip.bottom());
+			if (left >= right || top >= bottom || image.getWidth() == 0 || image.getHeight() == 0){return;
+			}
+			//Tiles can be drawn on several threads at once, so each thread has its own buffers
+			static thread_local std::vector<Pixel> rowBuffer;
+			static thread_local std::vector<uint32> xIndexTable, yIndexTable;
+			const Pixel* imageData = image.getPixelData();
+			uint32 imageWidth = image.getWidth(), imageHeight = image.getHeight();
+			//skipX and skipY are the destination columns and rows clipped off the left and top edges, the same pixels are read whatever the clip
+			const uint32 drawWidth = right - left, drawHeight = bottom - top, skipX = left - dstX, skipY = top - dstY;
+			srcX %= imageWidth;
+			srcY %= imageHeight;
+			rowBuffer.resize(drawWidth);
+			//funcPtr can change the alpha, so the rows are only copied if it isn't set
+			const bool premultiplied = image.isPremultiplied(), opaque = funcPtr == nullptr && image.isOpaque();
+			MarkDirty(left, top, right, bottom);
+
+			if (drawType == DrawType::Resize)
+			{
+				//Shrunk draws read from the closest mip level if the image has mipmaps enabled
+				uint32 level = image.selectMipLevel((float)width / (float)(imageWidth - srcX), (float)height / (float)(imageHeight - srcY));
+				if (level != 0)
+				{
+					const Image& mip = image.getMipLevel(level);
+					srcX = ((uint64)srcX * mip.getWidth()) / imageWidth;
+					srcY = ((uint64)srcY * mip.getHeight()) / imageHeight;
+					imageData = mip.getPixelData();
+					imageWidth = mip.getWidth();
+					imageHeight = mip.getHeight();
+				}
+				float scaleX = (float)(imageWidth - srcX) / (float)width, scaleY = (float)(imageHeight - srcY) / (float)height;
+				buildIndexTable(xIndexTable, drawWidth, scaleX, srcX, imageWidth - 1, skipX);
+				buildIndexTable(yIndexTable, drawHeight, scaleY, srcY, imageHeight - 1, skipY);
+			}
+			for (uint32 dy = 0; dy < drawHeight; ++dy)
+			{
+				//Gather the source row, then draw it in one go
+				if (drawType == DrawType::Repeat)
+				{
+					const Pixel* src = &imageData[((srcY + (skipY % imageHeight) + dy) % imageHeight) * imageWidth];
+					uint32 x = (srcX + (skipX % imageWidth)) % imageWidth;
+					for (uint32 dx = 0; dx < drawWidth;)
+					{
+						uint32 count = std::min(imageWidth - x, drawWidth - dx);
+						std::copy(src + x, src + x + count, &rowBuffer[dx]);
+						dx += count;
+						x = 0;
+					}
+				}
+				else if (dy == 0 || yIndexTable[dy] != yIndexTable[dy - 1] || funcPtr != nullptr)
+				{
+					//Rows that use the same source row reuse the buffer
+					gatherNearest(rowBuffer.data(), &imageData[yIndexTable[dy] * imageWidth], xIndexTable.data(), drawWidth);
+				}
+
+				if (funcPtr != nullptr)
+				{
+					for (uint32 dx = 0; dx < drawWidth; ++dx)
+					{
+						applyPixelFunc(rowBuffer[dx], funcPtr, funcData);
+					}
+				}
+				DrawRow(&pixels[((top + dy) * this->width) + left], rowBuffer.data(), drawWidth, blend, premultiplied, opaque);
+			}
+			return;
+		}
+		//Bounding box of the image corners in the buffer
+		static void TransformedBounds(const Image& image, const AffineTransform& transform, float& minX, float& minY, float& maxX, float& maxY)
+		{
+			minX = std::numeric_limits<float>::max(), minY = minX, maxX = -minX, maxY = -minX;
+			for (uint32 i = 0; i < 4; ++i)
+			{
+				float x, y;
+				transform.apply((i & 1) ? (float)image.getWidth() : 0.f, (i & 2) ? (float)image.getHeight() : 0.f, x, y);
+				minX = std::min(minX, x), maxX = std::max(maxX, x);
+				minY = std::min(minY, y), maxY = std::max(maxY, y);
+			}
+			return;
+		}
+		//drawTransformed() limited to clip
+		void DrawTransformed(Image& image, const AffineTransform& transform, InterpolationMethod im, bool blend, const Rect& clip)
+		{
+			AffineTransform inverse;
+			if (image.getWidth() == 0 || image.getHeight() == 0 || clip.width == 0 || clip.height == 0 || !transform.invert(inverse)){return;
+			}
+			float minX, minY, maxX, maxY;
+			TransformedBounds(image, transform, minX, minY, maxX, maxY);
+			//Rows start walking from rowLeft whatever the clip, so every clip samples the image at the same points
+			const int64 rowLeft = (int64)std::max<float>(floor(minX), 0.f);
+			const int64 left = std::max<int64>(rowLeft, clip.x), right = (int64)std::min<float>(ceil(maxX), (float)clip.right());
+			const int64 top = (int64)std::max<float>(floor(minY), (float)clip.y), bottom = (int64)std::min<float>(ceil(maxY), (float)clip.bottom());
+			if (left >= right || top >= bottom){return;
+			}
+
+			const Image* source = &image;
+			uint32 level = image.selectMipLevel(sqrtf((transform.a * transform.a) + (transform.d * transform.d)), sqrtf((transform.b * transform.b) + (transform.e * transform.e)));
+			if (level != 0)
+			{
+				source = &image.getMipLevel(level);
+				const float scaleX = (float)source->getWidth() / (float)image.getWidth(), scaleY = (float)source->getHeight() / (float)image.getHeight();
+				inverse.a *= scaleX, inverse.b *= scaleX, inverse.c *= scaleX;
+				inverse.d *= scaleY, inverse.e *= scaleY, inverse.f *= scaleY;
+			}
+			const Pixel* src = source->getPixelData();
+			const int64 srcWidth = source->getWidth(), srcHeight = source->getHeight();
+			const bool bilinear = im == InterpolationMethod::Bilinear, premultiplied = source->isPremultiplied(), opaque = image.isOpaque();
+			static thread_local std::vector<Pixel> rowBuffer;
+			if (rowBuffer.size() < (uint64)(right - left)){rowBuffer.resize(right - left);
+			}
+			MarkDirty(left, top, right, bottom);
+
+			//Image coordinates are walked in 16.16 fixed point, one step per buffer pixel
+			const int64 du = ToFixed16(inverse.a), dv = ToFixed16(inverse.d);
+			for (int64 y = top; y < bottom; ++y)
+			{
+				const double centreX = rowLeft + 0.5, centreY = y + 0.5;
+				const int64 u = ToFixed16((inverse.a * centreX) + (inverse.b * centreY) + inverse.c) + ((left - rowLeft) * du);
+				const int64 v = ToFixed16((inverse.d * centreX) + (inverse.e * centreY) + inverse.f) + ((left - rowLeft) * dv);
+				int64 first = 0, last = right - left - 1;
+				ClipSteps(u, du, (srcWidth << 16) - 1, first, last);
+				ClipSteps(v, dv, (srcHeight << 16) - 1, first, last);
+				if (first > last){continue;
+				}
+
+				int64 cu = u + (first * du), cv = v + (first * dv);
+				const uint32 count = (uint32)(last - first + 1);
+				if (bilinear)
+				{
+					for (uint32 i = 0; i < count; ++i, cu += du, cv += dv)
+					{
+						//Texel centres are at +0.5, the neighbours are clamped to the image edge
+						const int64 su = cu - 32768, sv = cv - 32768;
+						const int64 tx = su >> 16, ty = sv >> 16;
+						const int64 tx0 = std::max<int64>(tx, 0), tx1 = std::min<int64>(tx + 1, srcWidth - 1);
+						const Pixel* row0 = &src[std::max<int64>(ty, 0) * srcWidth];
+						const Pixel* row1 = &src[std::min<int64>(ty + 1, srcHeight - 1) * srcWidth];
+						const uint32 fx = (uint32)(su >> 8) & 0xFF, fy = (uint32)(sv >> 8) & 0xFF;
+						const uint32 upper = LerpARGB(row0[tx0].getARGB(), row0[tx1].getARGB(), fx);
+						const uint32 lower = LerpARGB(row1[tx0].getARGB(), row1[tx1].getARGB(), fx);
+						rowBuffer[i].setARGB(LerpARGB(upper, lower, fy));
+					}
+				}
+				else {
+					for (uint32 i = 0; i < count; ++i, cu += du, cv += dv)
+					{
+						rowBuffer[i] = src[((cv >> 16) * srcWidth) + (cu >> 16)];
+					}
+				}
+				DrawRow(&pixels[(y * width) + left + first], rowBuffer.data(), count, blend, premultiplied, opaque);
+			}
+			return;
+		}
+
+		uint32& accessBuffer(uint32 x, uint32 y){return pixels[(y * width) + x];
+		}
+		uint32& accessBuffer(uint32 index){return pixels[index];
+		}
+
+	public:
+		ConsoleGraphics()
+		{
+			initialise();
+			CreateDefaultBackend();
+			backend = defaultBackend.get();
+		#ifdef CG_WINDOWS
+			GetWindowSize(GetConsoleWindow(), consoleWidth, consoleHeight);
+			RemoveScrollbar();
+		#else
+			consoleWidth = 256;
+			consoleHeight = 256;
+		#endif
+			CreateBuffer(consoleWidth, consoleHeight);
+		}
+
+		ConsoleGraphics(uint32 width, uint32 height, bool setSize = false, uint16 pixelSize = 1, bool pixelMode = false)
+		{
+			initialise();
+			CreateDefaultBackend();
+			backend = defaultBackend.get();
+			this->pixelSize = std::max<uint16>(pixelSize, 1);
+		#ifdef CG_WINDOWS
+			GetWindowSize(GetConsoleWindow(), consoleWidth, consoleHeight);
+		#else
+			consoleWidth = width;
+			consoleHeight = height;
+		#endif
+			this->width = width / (!pixelMode ? 1 : pixelSize);
+			this->height = height / (!pixelMode ? 1 : pixelSize);
+
+		#ifdef CG_WINDOWS
+			if (setSize || pixelMode)
+			{
+				//Get windows version and add offset to window size
+				uint16 windowWidthOffset = 0, windowHeightOffset = 0;
+				SetConsoleSize(consoleWidth + windowWidthOffset, consoleHeight + windowHeightOffset);
+			}
+		#else
+			//There's no console window to resize
+			(void)setSize;
+		#endif
+
+			CreateBuffer(this->width, this->height);
+		}
+
+		//Draw into a buffer owned by a custom backend (e.g. cg::MemoryBackend for headless rendering), the console isn't touched
+		ConsoleGraphics(uint32 width, uint32 height, RenderBackend* backend, uint16 pixelSize = 1)
+		{
+			initialise();
+			this->backend = backend;
+			this->pixelSize = std::max<uint16>(pixelSize, 1);
+			consoleWidth = width * this->pixelSize;
+			consoleHeight = height * this->pixelSize;
+			CreateBuffer(width, height);
+		}
+
+		~ConsoleGraphics()
+		{
+			StopPresenter();
+		}
+
+		bool display(void)
+		{
+			bool returnValue = true;
+			if (recordCommands){flushCommands();
+			}
+			PresentInfo info;
+			info.width = width;
+			info.height = height;
+			info.outputX = startX;
+			info.outputY = startY;
+			info.outputWidth = consoleWidth;
+			info.outputHeight = consoleHeight;
+			info.outputScale = outputScale;
+			info.pixelSize = pixelSize;
+			info.mode = renderMode;
+
+			if (dirtyTracking)
+			{
+				//Only the changed areas are shaded and presented
+				uint64 redrawn = 0;
+				for (uint32 i = 0; i < dirtyRects.size(); ++i)
+				{
+					redrawn += dirtyRects[i].area();
+				}
+				//dirtyRects can't be nullptr here, that would mean the whole buffer
+				static const Rect noRects;
+				info.dirtyRects = dirtyRects.empty() ? &noRects : dirtyRects.data();
+				info.dirtyRectCount = dirtyRects.size();
+				redrawFraction = width != 0 && height != 0 ? (float)((double)redrawn / ((double)width * height)) : 0.f;
+			}
+			else {
+				info.dirtyRects = nullptr;
+				info.dirtyRectCount = 0;
+				redrawFraction = 1.f;
+			}
+
+			if (!frameSlots.empty())
+			{
+				SubmitFrame(info);
+				returnValue = lastPresentResult;
+			}
+			else {
+				if (enableShaders)
+				{
+					for (uint32 i = 0; i < (dirtyTracking ? dirtyRects.size() : 1); ++i)
+					{
+						RunShaders(pixels, shaderList, dirtyTracking ? dirtyRects[i] : Rect(0, 0, width, height));
+					}
+				}
+				returnValue = backend->present(pixels, info);
+			}
+			dirtyRects.clear();
+
+			return returnValue;
+		}
+
+		void setRenderMode(RenderMode mode)
+		{
+			renderMode = mode;
+			return;
+		}
+		void enableAlpha(void)
+		{
+			this->alphaMode = true;
+			return;
+		}
+		void disableAlpha(void)
+		{
+			this->alphaMode = false;
+			return;
+		}
+
+		//Clear window with grayscale value
+		void clear(uint8 c = 0x00)
+		{
+			if (recordCommands)
+			{
+				DrawCommand* command = PushCommand(CommandType::Clear, 0, 0, width, height);
+				if (command != nullptr){command->rgb = c;
+				}
+				return;
+			}
+			memset(pixels, c, width * height * sizeof(uint32));
+			MarkDirty(0, 0, width, height);
+			return;
+		}
+
+		void setPixel(uint32 x, uint32 y, uint32 rgb)
+		{
+			if (recordCommands)
+			{
+				DrawCommand* command = PushCommand(CommandType::Pixel, x, y, (int64)x + 1, (int64)y + 1);
+				if (command != nullptr)
+				{
+					command->a[0] = x, command->a[1] = y;
+					command->rgb = rgb;
+				}
+				return;
+			}
+			if (x < width && y < height)
+			{
+				pixels[(y * width) + x] = rgb;
+				MarkDirty(x, y, (int64)x + 1, (int64)y + 1);
+			}
+			return;
+		}
+		void drawPixel(uint32 x, uint32 y, uint32 rgb, uint8 a)
+		{
+			if (recordCommands)
+			{
+				DrawCommand* command = PushCommand(CommandType::PixelA, x, y, (int64)x + 1, (int64)y + 1);
+				if (command != nullptr)
+				{
+					command->a[0] = x, command->a[1] = y;
+					command->rgb = rgb;
+					command->alpha = a;
+				}
+				return;
+			}
+			if (x < width && y < height && alphaMode)
+			{
+				pixels[(y * width) + x] = blendPixel(pixels[(y * width) + x], rgb, a);
+				MarkDirty(x, y, (int64)x + 1, (int64)y + 1);
+			}
+			return;
+		}
+		uint32* getPixel(uint32 x, uint32 y)
+		{
+			if (x < width && y < height){return &pixels[(y * width) + x];
+			} else return nullptr;
+		}
+		uint32* accessPixel(uint32 x, uint32 y){return &pixels[(y * width) + x];
+		}
+		//Buffer pixels are 0x00RRGGBB, the top byte is unused and may hold anything (e.g. the alpha of a copied image)
+		//With asynchronous presenting the buffer changes every display()
+		const uint32* getPixelData(void) const {return pixels;
+		}
+
+		uint32 getWidth(void){return width;
+		}
+		uint32 getHeight(void){return height;
+		}
+
+		uint32 getConsoleWidth(void){return consoleWidth;
+		}
+		uint32 getConsoleHeight(void){return consoleHeight;
+		}
+
+		uint16 getPixelSize(void){return pixelSize;
+		}
+
+		//Dirty rectangles, when enabled display() only shades and presents the areas draw calls changed since the last display()
+		//Writes made straight to the buffer (accessPixel(), getPixel()) have to be reported with markDirty()
+		//Shaders only run on the changed areas, pixels outside them keep last frame's shaded values even if a halo shader would read the change
+		void enableDirtyRects(bool enable = true)
+		{
+			dirtyTracking = enable;
+			dirtyRects.clear();
+			//Nothing is known about what the backend shows, so the first frame is sent whole
+			MarkDirty(0, 0, width, height);
+			return;
+		}
+		bool dirtyRectsEnabled(void){return dirtyTracking;
+		}
+		void markDirty(int32 x, int32 y, uint32 width, uint32 height)
+		{
+			MarkDirty(x, y, (int64)x + width, (int64)y + height);
+			return;
+		}
+		//At most 8 disjoint rectangles covering everything changed since the last display()
+		const std::vector<Rect>& getDirtyRects(void){return dirtyRects;
+		}
+		//Fraction of the buffer the last display() shaded and presented, 1 without dirty rectangles
+		float getRedrawFraction(void){return redrawFraction;
+		}
+
+		//Presents frames on a background thread, display() hands the frame over and returns so the next frame is drawn while the last one is output
+		//bufferCount = 2 is double buffering (one frame presenting while the next is drawn), 3 is triple buffering (one more finished frame can wait)
+		//display() only blocks when every other buffer is still queued, each new buffer starts as a copy of the frame that was just displayed
+		//Shaders run on the presenter thread on a copy of the frame, so unlike synchronous presenting the buffer that is drawn into isn't shaded
+		//display() returns the result of the last frame the presenter finished
+		void enableAsyncPresent(uint32 bufferCount = 2)
+		{
+			disableAsyncPresent();
+			frameSlots.resize(std::max<uint32>(bufferCount, 2));
+			for (uint32 i = 0; i < frameSlots.size(); ++i)
+			{
+				frameSlots[i].pixels.assign(pixels, pixels + (width * height));
+				frameSlots[i].staleAll = false;
+			}
+			framesSubmitted = 0;
+			framesPresented = 0;
+			stopPresenter = false;
+			lastPresentResult = true;
+			pixels = frameSlots[0].pixels.data();
+			presenterThread = std::thread(&ConsoleGraphics::PresenterLoop, this);
+			return;
+		}
+		//Presents the queued frames, then goes back to presenting on the calling thread
+		void disableAsyncPresent(void)
+		{
+			if (frameSlots.empty()){return;
+			}
+			StopPresenter();
+			memcpy(backendPixels, pixels, width * height * sizeof(uint32));
+			pixels = backendPixels;
+			frameSlots.clear();
+			//The backend's buffer may have been shaded
+			MarkDirty(0, 0, width, height);
+			return;
+		}
+		bool asyncPresentEnabled(void){return !frameSlots.empty();
+		}
+		uint32 getBufferCount(void){return frameSlots.empty() ? 1 : frameSlots.size();
+		}
+		//Waits until every displayed frame has been presented
+		void waitForPresent(void)
+		{
+			if (!frameSlots.empty()){WaitFor(callerWaiting, [&]{return framesPresented == framesSubmitted;});
+			}
+			return;
+		}
+
+		//Pixelizes the output already drawn to the screen (this is a very costly function, only use when nessesary)
+		void pixelize(const float ratio)
+		{
+			if (!(ratio <= 1.f) && ratio < width && ratio < height)
+			{
+				//The buffer may be recreated, so the presenter is stopped first
+				const uint32 bufferCount = frameSlots.size();
+				disableAsyncPresent();
+				uint32 oldWidth = width, oldHeight = height;
+				std::vector<uint32> data(pixels, pixels + (width * height));
+				data = ResizeDataNearestNeighbor(data, width / ratio, height / ratio);
+				data = ResizeDataNearestNeighbor(data, consoleWidth / pixelSize, consoleHeight / pixelSize);
+				if (width != oldWidth || height != oldHeight){pixels = backendPixels = backend->createBuffer(width, height);
+				}
+				memcpy(pixels, data.data(), data.size() * sizeof(uint32));
+				MarkDirty(0, 0, width, height);
+				if (bufferCount != 0){enableAsyncPresent(bufferCount);
+				}
+			}
+			return;
+		}
+
+		void lineHorizontal(uint32 x, uint32 y, uint32 iterations, uint32 rgb, bool forward = true)
+		{
+			if (recordCommands)
+			{
+				DrawCommand* command = PushCommand(CommandType::Span, forward ? (int64)x : (int64)x - iterations + 1, y, forward ? (int64)x + iterations : (int64)x + 1, (int64)y + 1);
+				if (command != nullptr)
+				{
+					command->a[0] = x, command->a[1] = y, command->a[2] = iterations;
+					command->rgb = rgb;
+					command->flags = (forward ? 1 : 0);
+				}
+				return;
+			}
+			//Backward spans end at (x, y), only the part inside the buffer is drawn
+			const int64 first = forward ? (int64)x : (int64)x - iterations + 1, last = forward ? (int64)x + iterations : (int64)x + 1;
+			MarkDirty(first, y, last, (int64)y + 1);
+			FillRect(first, y, last, (int64)y + 1, rgb, 255, false, BufferRect());
+			return;
+		}
+
+		void lineVertical(uint32 x, uint32 y, uint32 iterations, uint32 rgb, bool forward = true)
+		{
+			if (recordCommands)
+			{
+				DrawCommand* command = PushCommand(CommandType::Span, x, forward ? (int64)y : (int64)y - iterations + 1, (int64)x + 1, forward ? (int64)y + iterations : (int64)y + 1);
+				if (command != nullptr)
+				{
+					command->a[0] = x, command->a[1] = y, command->a[2] = iterations;
+					command->rgb = rgb;
+					command->flags = 2 | (forward ? 1 : 0);
+				}
+				return;
+			}
+			const int64 first = forward ? (int64)y : (int64)y - iterations + 1, last = forward ? (int64)y + iterations : (int64)y + 1;
+			MarkDirty(x, first, (int64)x + 1, last);
+			FillRect(x, first, (int64)x + 1, last, rgb, 255, false, BufferRect());
+			return;
+		}
+
+		//Draws a line including both end points, the end points can be outside of the buffer
+		void drawLine(int32 x0, int32 y0, int32 x1, int32 y1, uint32 rgb, uint8 alpha = 255)
+		{
+			if (recordCommands)
+			{
+				DrawCommand* command = alpha != 0 ? PushCommand(CommandType::Line, std::min(x0, x1), std::min(y0, y1), (int64)std::max(x0, x1) + 1, (int64)std::max(y0, y1) + 1) : nullptr;
+				if (command != nullptr)
+				{
+					command->a[0] = x0, command->a[1] = y0, command->a[2] = x1, command->a[3] = y1;
+					command->rgb = rgb;
+					command->alpha = alpha;
+				}
+				return;
+			}
+			RasterLine(x0, y0, x1, y1, rgb, alpha, BufferRect());
+			return;
+		}
+		//Draws many lines in order, e.g. a wireframe
+		void drawLines(const LineSegment* lines, uint32 count)
+		{
+			if (width == 0 || height == 0){return;
+			}
+			for (uint32 i = 0; i < count; ++i)
+			{
+				drawLine(lines[i].x0, lines[i].y0, lines[i].x1, lines[i].y1, lines[i].rgb, lines[i].alpha);
+			}
+			return;
+		}
+		void drawLines(const std::vector<LineSegment>& lines)
+		{
+			drawLines(lines.data(), lines.size());
+			return;
+		}
+		//Anti-aliased line, the end points can be fractional and outside of the buffer
+		void drawLineAA(float x0, float y0, float x1, float y1, uint32 rgb, uint8 alpha = 255)
+		{
+			if (recordCommands)
+			{
+				DrawCommand* command = alpha != 0 ? PushCommandF(CommandType::LineAA, std::min(x0, x1) - 1.f, std::min(y0, y1) - 1.f, std::max(x0, x1) + 2.f, std::max(y0, y1) + 2.f) : nullptr;
+				if (command != nullptr)
+				{
+					command->v[0] = x0, command->v[1] = y0, command->v[2] = x1, command->v[3] = y1;
+					command->rgb = rgb;
+					command->alpha = alpha;
+				}
+				return;
+			}
+			RasterLineAA(x0, y0, x1, y1, rgb, alpha, BufferRect());
+			return;
+		}
+		//Anti-aliased connected lines through pointCount points stored as x, y pairs
+		void drawPolylineAA(const float* points, uint32 pointCount, uint32 rgb, uint8 alpha = 255, bool closed = false)
+		{
+			for (uint32 i = 1; i < pointCount; ++i)
+			{
+				drawLineAA(points[(i - 1) * 2], points[((i - 1) * 2) + 1], points[i * 2], points[(i * 2) + 1], rgb, alpha);
+			}
+			if (closed && pointCount > 2){drawLineAA(points[(pointCount - 1) * 2], points[((pointCount - 1) * 2) + 1], points[0], points[1], rgb, alpha);
+			}
+			return;
+		}
+		//Filled triangle, see RasterConvex() for which pixels are covered
+		void drawTriangle(float x0, float y0, float x1, float y1, float x2, float y2, uint32 rgb, uint8 alpha = 255)
+		{
+			const int64 points[6] = {ToFixed8(x0), ToFixed8(y0), ToFixed8(x1), ToFixed8(y1), ToFixed8(x2), ToFixed8(y2)};
+			DrawConvex(points, 3, rgb, alpha);
+			return;
+		}
+		//Draws many filled triangles in order, e.g. a mesh or a chart
+		void drawTriangles(const Triangle* triangles, uint32 count)
+		{
+			for (uint32 i = 0; i < count; ++i)
+			{
+				const Triangle& t = triangles[i];
+				const int64 points[6] = {ToFixed8(t.x0), ToFixed8(t.y0), ToFixed8(t.x1), ToFixed8(t.y1), ToFixed8(t.x2), ToFixed8(t.y2)};
+				DrawConvex(points, 3, t.rgb, t.alpha);
+			}
+			return;
+		}
+		void drawTriangles(const std::vector<Triangle>& triangles)
+		{
+			drawTriangles(triangles.data(), triangles.size());
+			return;
+		}
+		//Indexed triangle list, triangle i uses the x, y pairs vertices[indices[i * 3]] to vertices[indices[(i * 3) + 2]]
+		//rgb holds one colour per triangle
+		void drawTriangles(const float* vertices, const uint32* indices, uint32 triangleCount, const uint32* rgb, uint8 alpha = 255)
+		{
+			for (uint32 i = 0; i < triangleCount; ++i)
+			{
+				int64 points[6];
+				for (uint32 j = 0; j < 3; ++j)
+				{
+					points[j * 2] = ToFixed8(vertices[indices[(i * 3) + j] * 2]);
+					points[(j * 2) + 1] = ToFixed8(vertices[(indices[(i * 3) + j] * 2) + 1]);
+				}
+				DrawConvex(points, 3, rgb[i], alpha);
+			}
+			return;
+		}
+		//Filled convex polygon through pointCount points stored as x, y pairs
+		void drawPolygon(const float* points, uint32 pointCount, uint32 rgb, uint8 alpha = 255)
+		{
+			polygonPoints.resize(pointCount * 2);
+			for (uint32 i = 0; i < pointCount * 2; ++i)
+			{
+				polygonPoints[i] = ToFixed8(points[i]);
+			}
+			DrawConvex(polygonPoints.data(), pointCount, rgb, alpha);
+			return;
+		}
+		//Anti-aliased circle, fill = false draws a one pixel wide outline
+		void drawCircleAA(float cx, float cy, float radius, uint32 rgb, bool fill = false, uint8 alpha = 255)
+		{
+			if (recordCommands)
+			{
+				DrawCommand* command = alpha != 0 && radius > 0.f ? PushCommandF(CommandType::Circle, cx - radius - 2.f, cy - radius - 2.f, cx + radius + 2.f, cy + radius + 2.f) : nullptr;
+				if (command != nullptr)
+				{
+					command->v[0] = cx, command->v[1] = cy, command->v[2] = radius;
+					command->rgb = rgb;
+					command->alpha = alpha;
+					command->flags = fill ? 1 : 0;
+				}
+				return;
+			}
+			RasterCircleAA(cx, cy, radius, rgb, fill, alpha, BufferRect());
+			return;
+		}
+
+		void drawRect(uint32 x, uint32 y, uint32 width, uint32 height, uint32 rgb, bool fill = true)
+		{
+			if (recordCommands)
+			{
+				//Outlines include the right and bottom edges
+				DrawCommand* command = PushCommand(CommandType::Rect, x, y, (int64)x + width + (fill ? 0 : 1), (int64)y + height + (fill ? 0 : 1));
+				if (command != nullptr)
+				{
+					command->a[0] = x, command->a[1] = y, command->a[2] = width, command->a[3] = height;
+					command->rgb = rgb;
+					command->flags = fill ? 1 : 0;
+				}
+				return;
+			}
+			//Worked out in 64 bits so edges past 2^32 are clipped instead of wrapping around
+			if (fill)
+			{
+				MarkDirty(x, y, (int64)x + width, (int64)y + height);
+				FillRect(x, y, (int64)x + width, (int64)y + height, rgb, 255, false, BufferRect());
+			}
+			else {
+				//Each edge is marked on its own so a large outline doesn't dirty its inside
+				const int64 right = (int64)x + width, bottom = (int64)y + height;
+				MarkDirty(x, y, right, (int64)y + 1);
+				MarkDirty(right, y, right + 1, bottom);
+				MarkDirty((int64)x + 1, bottom, right + 1, bottom + 1);
+				MarkDirty(x, (int64)y + 1, (int64)x + 1, bottom + 1);
+				OutlineRect(x, y, width, height, rgb, BufferRect());
+			}
+			return;
+		}
+		void drawRectA(uint32 x, uint32 y, uint32 width, uint32 height, uint32 rgb, uint8 a)
+		{
+			if (recordCommands)
+			{
+				DrawCommand* command = PushCommand(CommandType::RectA, x, y, (int64)x + width, (int64)y + height);
+				if (command != nullptr)
+				{
+					command->a[0] = x, command->a[1] = y, command->a[2] = width, command->a[3] = height;
+					command->rgb = rgb;
+					command->alpha = a;
+				}
+				return;
+			}
+			if (x >= this->width || y >= this->height){return;
+			}
+			width = std::min(width, this->width - x);
+			height = std::min(height, this->height - y);
+			MarkDirty(x, y, (int64)x + width, (int64)y + height);
+			for (uint32 dy = y; dy < y + height; ++dy)
+			{
+				blendSpan(&pixels[(dy * this->width) + x], rgb, a, width);
+			}
+			return;
+		}
+
+		//Enable Post-Processing shaders
+		void enablePPShaders(void)
+		{
+			enableShaders = true;
+			return;
+		}
+		//Disable Post-Processing shaders
+		void disablePPShaders(void)
+		{
+			enableShaders = false;
+			return;
+		}
+		//Load Post-Processing shaders for ConsoleGraphics to use
+		//haloRadius = number of rows above and below the current row the shader reads, those rows hold the previous shader's output
+		void loadPPShader(PixelShader funcPtr, void* shaderData = nullptr, uint32 haloRadius = 0)
+		{
+			Shader shader = {funcPtr, nullptr, shaderData, haloRadius};
+			shaderList.push_back(shader);
+			return;
+		}
+		//Load a Post-Processing shader that works on a span of a row at a time (much less call overhead than per pixel shaders)
+		void loadPPShader(SpanShader funcPtr, void* shaderData = nullptr, uint32 haloRadius = 0)
+		{
+			Shader shader = {nullptr, funcPtr, shaderData, haloRadius};
+			shaderList.push_back(shader);
+			return;
+		}
+		//Clear all Post-Processing shaders
+		void clearPPShaders(void)
+		{
+			shaderList.clear();
+			return;
+		}
+
+		//Command buffer, when enabled draw calls are recorded instead of drawn and flushCommands() (or display()) draws them
+		//Commands outside the buffer are dropped when recorded, the rest are sorted (see setCommandSort()) and drawn in batches
+		//Images are read when the commands are flushed, so they have to stay alive and unchanged until then
+		//Functions that read or change the buffer directly (getPixel(), pixelize(), ...) don't see recorded commands until they are flushed
+		void enableCommandBuffer(void)
+		{
+			recordCommands = true;
+			return;
+		}
+		void disableCommandBuffer(void)
+		{
+			if (recordCommands){flushCommands();
+			}
+			recordCommands = false;
+			return;
+		}
+		bool commandBufferEnabled(void){return recordCommands;
+		}
+		//Layer of the commands recorded after this call, lower layers are drawn first
+		void setLayer(int32 layer)
+		{
+			commandLayer = layer;
+			return;
+		}
+		int32 getLayer(void){return commandLayer;
+		}
+		void setCommandSort(CommandSort sort)
+		{
+			commandSort = sort;
+			return;
+		}
+		CommandSort getCommandSort(void){return commandSort;
+		}
+		//Tiled rendering, flushed commands are binned into tileSize x tileSize tiles and the tiles are drawn in parallel on ThreadPool::getShared()
+		//Each tile draws its commands in the same order, so the output is the same as drawing them one after another
+		//Turns the command buffer on, and only has an effect if the shared pool has more than one thread
+		//drawEX() pixel functions are called from several threads at once (still once per pixel), so they must be thread safe
+		void enableTiledRendering(uint32 tileSize = 64)
+		{
+			this->tileSize = std::max<uint32>(tileSize, 1);
+			enableCommandBuffer();
+			return;
+		}
+		//Flushed commands are drawn on the calling thread again, the command buffer stays on
+		void disableTiledRendering(void)
+		{
+			tileSize = 0;
+			return;
+		}
+		bool tiledRenderingEnabled(void){return tileSize != 0;
+		}
+		uint32 getTileSize(void){return tileSize;
+		}
+		//Number of commands waiting to be flushed
+		uint32 getCommandCount(void){return commandList.size();
+		}
+		//Sorts and draws the recorded commands, they are kept for replayCommands() until the next flush
+		CommandStats flushCommands(void)
+		{
+			if (commandSort == CommandSort::Layer)
+			{
+				std::stable_sort(commandList.begin(), commandList.end(), [](const DrawCommand& a, const DrawCommand& b){return a.layer < b.layer;});
+			}
+			else if (commandSort == CommandSort::LayerImage)
+			{
+				std::stable_sort(commandList.begin(), commandList.end(), [](const DrawCommand& a, const DrawCommand& b){return a.layer < b.layer;});
+				GroupImageRuns();
+			}
+			CommandStats stats = ExecuteCommands(commandList, commandPoints, culledCommands, UseTiles());
+
+			//The lists swap so neither allocates again next frame
+			std::swap(commandList, replayList);
+			std::swap(commandPoints, replayPoints);
+			replayCulled = culledCommands;
+			commandList.clear();
+			commandPoints.clear();
+			culledCommands = 0;
+			return stats;
+		}
+		//Draws the last flushed commands again in the same order (e.g. to profile a frame), their images must still be alive
+		CommandStats replayCommands(void)
+		{
+			return ExecuteCommands(replayList, replayPoints, replayCulled, UseTiles());
+		}
+
+		//Draws image to a buffer, premultiplied images (see Image::premultiplyAlpha()) are blended with src + dst * (1 - a)
+		void draw(Image& image)
+		{
+			if (recordCommands)
+			{
+				//The position is recorded so the same image can be drawn in several places
+				DrawCommand* command = PushCommand(CommandType::Image, image.getPosX(), image.getPosY(), (int64)image.getPosX() + image.getWidth(), (int64)image.getPosY() + image.getHeight());
+				if (command != nullptr)
+				{
+					command->image = &image;
+					command->a[0] = image.getPosX(), command->a[1] = image.getPosY();
+				}
+				return;
+			}
+			DrawImage(image, image.getPosX(), image.getPosY(), alphaMode, BufferRect());
+			return;
+		}
+		void draw(Text& text)
+		{
+			this->draw(text.getTextImage());
+			return;
+		}
+		//drawType = DrawType::Repeat - if width > image.width() or height > image.height(), the image will be tiled
+		//drawType = DrawType::Resized - if width > image.width() or height > image.height(), the image will be resampled using nearest neighbor interpolation
+		//If the image has mipmaps enabled (Image::enableMipmaps()), shrunk draws read from the closest mip level
+		//A more advanced version of the draw function
+		//dstX and dstY can be negative, only the part of the destination rectangle inside the buffer is drawn
+		void drawEX(Image& image, uint32 srcX, uint32 srcY, int32 dstX, int32 dstY, uint32 width, uint32 height, DrawType drawType = DrawType::Repeat, void(*funcPtr)(std::pair<uint32, uint8>*, void*) = nullptr, void* funcData = nullptr)
+		{
+			if (recordCommands)
+			{
+				DrawCommand* command = PushCommand(CommandType::ImageEX, dstX, dstY, (int64)dstX + width, (int64)dstY + height);
+				if (command != nullptr)
+				{
+					command->image = &image;
+					command->a[0] = srcX, command->a[1] = srcY, command->a[2] = dstX, command->a[3] = dstY, command->a[4] = width, command->a[5] = height;
+					command->flags = (uint8)drawType;
+					command->funcPtr = funcPtr;
+					command->funcData = funcData;
+				}
+				return;
+			}
+			DrawImageEX(image, srcX, srcY, dstX, dstY, width, height, drawType, funcPtr, funcData, alphaMode, BufferRect());
+			return;
+		}
+
+		//Draws image under an affine transform that maps image coordinates to buffer coordinates (rotation, scale, shear)
+		//Each buffer pixel whose centre maps inside the image is drawn, only the clipped bounding box of the image is visited
+		//im = InterpolationMethod::Bilinear filters the image, every other method uses nearest neighbor
+		//If the image has mipmaps enabled (Image::enableMipmaps()), shrunk draws read from the closest mip level
+		void drawTransformed(Image& image, const AffineTransform& transform, InterpolationMethod im = InterpolationMethod::NearestNeighbor)
+		{
+			if (recordCommands)
+			{
+				float minX, minY, maxX, maxY;
+				TransformedBounds(image, transform, minX, minY, maxX, maxY);
+				DrawCommand* command = PushCommandF(CommandType::Transformed, minX, minY, maxX, maxY);
+				if (command != nullptr)
+				{
+					command->image = &image;
+					command->v[0] = transform.a, command->v[1] = transform.b, command->v[2] = transform.c;
+					command->v[3] = transform.d, command->v[4] = transform.e, command->v[5] = transform.f;
+					command->flags = (uint8)im;
+				}
+				return;
+			}
+			DrawTransformed(image, transform, im, alphaMode, BufferRect());
+			return;
+		}
+
+		void setTitle(const std::string title)
+		{
+			this->title = title;
+		#ifdef CG_WINDOWS
+			SetConsoleTitleA(this->title.c_str());
+		#endif
+			return;
+		}
+		std::string getTitle(void){return title;
+		}
+
+		void setOutputScale(float s)
+		{
+			outputScale = s;
+			return;
+		}
+		float getOutputScale(void){return outputScale;
+		}
+
+		void setOutputPos(uint32 x, uint32 y)
+		{
+			startX = x;
+			startY = y;
+			return;
+		}
+		uint32 getOutputPosX(void){return startX;
+		}
+		uint32 getOutputPosY(void){return startY;
+		}
+
+	#ifdef CG_WINDOWS
+		void setRenderTarget(HWND hwnd)
+		{
+			setRenderTarget(GetDC(hwnd));
+			return;
+		}
+		void setRenderTarget(HDC hdc)
+		{
+			GDIBackend* gdi = dynamic_cast<GDIBackend*>(backend);
+			if (gdi != nullptr)
+			{
+				waitForPresent(); //The presenter thread may be using the target
+				gdi->setTarget(hdc);
+			}
+			else {
+				#ifdef CG_DEBUG
+					std::cerr << "CGOUT ERROR {this->setRenderTarget()}: Current backend isn't a GDIBackend" << std::endl;
+				#endif
+			}
+			return;
+		}
+		HWND getRenderTarget(void)
+		{
+			GDIBackend* gdi = dynamic_cast<GDIBackend*>(backend);
+			return gdi != nullptr ? WindowFromDC(gdi->getTarget()) : NULL;
+		}
+	#endif
+
+		//Use a different backend (the backend isn't owned by ConsoleGraphics), pass nullptr to go back to the default backend
+		//The current frame is copied into the new backend's buffer
+		void setBackend(RenderBackend* newBackend)
+		{
+			if (newBackend == nullptr)
+			{
+				if (defaultBackend == nullptr){CreateDefaultBackend();
+				}
+				newBackend = defaultBackend.get();
+			}
+			if (newBackend == backend){return;
+			}
+			const uint32 bufferCount = frameSlots.size();
+			disableAsyncPresent();
+			std::vector<uint32> frame(pixels, pixels + (width * height));
+			backend = newBackend;
+			pixels = backendPixels = backend->createBuffer(width, height);
+			memcpy(pixels, frame.data(), frame.size() * sizeof(uint32));
+			//The new backend hasn't shown anything yet
+			MarkDirty(0, 0, width, height);
+			if (bufferCount != 0){enableAsyncPresent(bufferCount);
+			}
+			return;
+		}
+		RenderBackend* getBackend(void){return backend;
+		}
+	};
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,64 @@
+//Shared helpers for the benchmarks in this folder
+//Each benchmark is a standalone program, build and run one from the repository root with optimisations on, e.g.
+//  g++ -std=c++11 -O2 -pthread -I. bench/PixelBench.cpp -o PixelBench && ./PixelBench
+//Timings are the fastest of several runs so background load doesn't inflate them
+#pragma once
+#define CG_HEADLESS
+#include "ConsoleGraphics.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace bench
+{
+	//Seconds taken by the fastest of repeats calls to func, after one call to warm the caches up
+	template<typename F> double Time(uint32 repeats, F func)
+	{
+		func();
+		double best = 1e30;
+		for (uint32 i = 0; i < repeats; ++i)
+		{
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			func();
+			best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		}
+		return best;
+	}
+
+	//Prints a checksum of the results, so the work that made them isn't optimised away
+	inline void Use(uint32 value)
+	{
+		std::printf("Checksum %08X\n", value);
+		return;
+	}
+
+	//Deterministic random numbers so every run draws the same thing
+	inline std::mt19937& Random(void)
+	{
+		static std::mt19937 random(1234);
+		return random;
+	}
+
+	//Image of random colours, opaque images have every alpha at 255 and the rest have a third of them opaque and some fully transparent
+	inline cg::Image RandomImage(uint32 width, uint32 height, bool opaque)
+	{
+		std::vector<cg::Pixel> pixels(width * height);
+		for (uint32 i = 0; i < pixels.size(); ++i)
+		{
+			uint32 argb = Random()();
+			if (opaque || i % 3 == 0){argb |= 0xFF000000;
+			}
+			else if (i % 7 == 0){argb &= 0x00FFFFFF;
+			}
+			pixels[i].setARGB(argb);
+		}
+		return cg::Image(pixels.data(), width, height);
+	}
+
+	//Prints one result line, the time per call and the throughput in millions of pixels a second
+	inline void Report(const char* name, double seconds, double pixels)
+	{
+		std::printf("  %-36s %9.3f ms %10.1f MPix/s\n", name, seconds * 1000.0, pixels / seconds / 1e6);
+		return;
+	}
+}
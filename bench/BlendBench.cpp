@@ -0,0 +1,67 @@
+//The blend:: row kernels, the scalar versions against the ones blendRow(), blendSpan() and friends pick at runtime
+//Building with -DCG_NO_SIMD compiles the SIMD kernels out, both columns are then the scalar path:
+//  g++ -std=c++11 -O2 -pthread -I. -DCG_NO_SIMD bench/BlendBench.cpp -o BlendBenchNoSIMD && ./BlendBenchNoSIMD
+#include "BenchCommon.hpp"
+
+//Name of the kernels the runtime dispatch picks on this machine
+static const char* DispatchedPath(void)
+{
+#ifdef CG_AVX2
+	if (cg::blend::GetRowFunc() == cg::blend::RowAVX2){return "AVX2";
+	}
+#endif
+#ifdef CG_SSE2
+	if (cg::blend::GetRowFunc() == cg::blend::RowSSE2){return "SSE2";
+	}
+#endif
+	return "scalar";
+}
+
+//Runs kernel over every row of a 1920x1080 frame with the SIMD kernels off and on
+template<typename F> static void TimeKernel(const char* name, std::vector<uint32>& frame, const std::vector<cg::Pixel>& src, uint32 width, uint32 height, F kernel)
+{
+	auto run = [&]()
+	{
+		for (uint32 y = 0; y < height; ++y)
+		{
+			kernel(&frame[y * width], &src[y * width], width);
+		}
+	};
+	cg::blend::UseSIMD() = false;
+	const double scalar = bench::Time(20, run);
+	cg::blend::UseSIMD() = true;
+	const double dispatched = bench::Time(20, run);
+	const double pixels = (double)width * height;
+	std::printf("  %-24s %9.1f %10.1f %8.2fx\n", name, pixels / scalar / 1e6, pixels / dispatched / 1e6, scalar / dispatched);
+	return;
+}
+
+int main(void)
+{
+	const uint32 width = 1920, height = 1080, rgb = 0x3366CC;
+	const uint8 alpha = 100;
+	std::vector<uint32> frame(width * height, 0x00808080);
+	std::vector<cg::Pixel> src(width * height), premultiplied(width * height);
+	for (uint32 i = 0; i < src.size(); ++i)
+	{
+		//A mix of opaque, transparent and translucent pixels, like a sprite with soft edges
+		uint32 argb = bench::Random()();
+		if (i % 3 == 0){argb |= 0xFF000000;
+		}
+		else if (i % 7 == 0){argb &= 0x00FFFFFF;
+		}
+		src[i].setARGB(argb);
+	}
+	cg::Image image(src.data(), width, height);
+	image.premultiplyAlpha();
+	premultiplied.assign(image.getPixelData(), image.getPixelData() + src.size());
+
+	std::printf("1920x1080 frame, runtime dispatch picks the %s kernels\n", DispatchedPath());
+	std::printf("  %-24s %9s %10s %9s\n", "kernel (MPix/s)", "scalar", "dispatched", "speedup");
+	TimeKernel("blendRow()", frame, src, width, height, [](uint32* dst, const cg::Pixel* s, uint32 n){cg::blendRow(dst, s, n);});
+	TimeKernel("blendRowPremultiplied()", frame, premultiplied, width, height, [](uint32* dst, const cg::Pixel* s, uint32 n){cg::blendRowPremultiplied(dst, s, n);});
+	TimeKernel("blendSpan()", frame, src, width, height, [&](uint32* dst, const cg::Pixel*, uint32 n){cg::blendSpan(dst, rgb, alpha, n);});
+	TimeKernel("fillSpan()", frame, src, width, height, [&](uint32* dst, const cg::Pixel*, uint32 n){cg::fillSpan(dst, rgb, n);});
+	bench::Use(frame[12345]);
+	return 0;
+}
@@ -0,0 +1,76 @@
+//A frame of chart lines drawn aliased with drawLine() and anti-aliased with drawLineAA() and drawPolylineAA()
+//Each series is a random walk across a 1080p buffer, so most segments are short and shallow like a real chart
+#include "BenchCommon.hpp"
+
+int main(void)
+{
+	const uint32 width = 1920, height = 1080, seriesCount = 20, pointCount = 250, repeats = 20;
+	const uint32 segments = seriesCount * (pointCount - 1);
+	cg::MemoryBackend backend;
+	cg::ConsoleGraphics graphics(width, height, &backend);
+
+	//x, y pairs of every series, the aliased lines use the same points rounded
+	std::vector<float> points(seriesCount * pointCount * 2);
+	std::vector<uint32> colours(seriesCount);
+	for (uint32 s = 0; s < seriesCount; ++s)
+	{
+		float y = 100.f + (bench::Random()() % (height - 200));
+		for (uint32 p = 0; p < pointCount; ++p)
+		{
+			y = std::min(std::max(y + (((int32)(bench::Random()() % 81) - 40) / 4.f), 0.f), height - 1.f);
+			points[(((s * pointCount) + p) * 2) + 0] = ((width - 1) * p) / (float)(pointCount - 1);
+			points[(((s * pointCount) + p) * 2) + 1] = y;
+		}
+		colours[s] = bench::Random()() & 0x00FFFFFF;
+	}
+
+	std::printf("%u series of %u points, %u segments on %ux%u\n", seriesCount, pointCount, segments, width, height);
+	std::printf("  %-30s %9s %12s %8s\n", "", "ms/frame", "Msegments/s", "ratio");
+	double aliased = 0.0;
+	for (uint8 alpha : {255, 128})
+	{
+		const double lineTime = bench::Time(repeats, [&]()
+		{
+			for (uint32 s = 0; s < seriesCount; ++s)
+			{
+				const float* p = &points[s * pointCount * 2];
+				for (uint32 i = 0; i + 1 < pointCount; ++i)
+				{
+					graphics.drawLine((int32)(p[i * 2] + 0.5f), (int32)(p[(i * 2) + 1] + 0.5f), (int32)(p[(i * 2) + 2] + 0.5f), (int32)(p[(i * 2) + 3] + 0.5f), colours[s], alpha);
+				}
+			}
+		});
+		const double lineAATime = bench::Time(repeats, [&]()
+		{
+			for (uint32 s = 0; s < seriesCount; ++s)
+			{
+				const float* p = &points[s * pointCount * 2];
+				for (uint32 i = 0; i + 1 < pointCount; ++i)
+				{
+					graphics.drawLineAA(p[i * 2], p[(i * 2) + 1], p[(i * 2) + 2], p[(i * 2) + 3], colours[s], alpha);
+				}
+			}
+		});
+		const double polylineTime = bench::Time(repeats, [&]()
+		{
+			for (uint32 s = 0; s < seriesCount; ++s)
+			{
+				graphics.drawPolylineAA(&points[s * pointCount * 2], pointCount, colours[s], alpha);
+			}
+		});
+		if (alpha == 255){aliased = lineTime;
+		}
+		std::printf("Alpha %u\n", alpha);
+		std::printf("  %-30s %9.3f %12.2f %7.2fx\n", "drawLine()", lineTime * 1000.0, segments / lineTime / 1e6, lineTime / aliased);
+		std::printf("  %-30s %9.3f %12.2f %7.2fx\n", "drawLineAA()", lineAATime * 1000.0, segments / lineAATime / 1e6, lineAATime / aliased);
+		std::printf("  %-30s %9.3f %12.2f %7.2fx\n", "drawPolylineAA()", polylineTime * 1000.0, segments / polylineTime / 1e6, polylineTime / aliased);
+	}
+	std::printf("Ratios are against opaque drawLine()\n");
+	uint32 checksum = 0;
+	for (uint32 i = 0; i < width * height; ++i)
+	{
+		checksum += graphics.getPixelData()[i];
+	}
+	bench::Use(checksum);
+	return 0;
+}
@@ -0,0 +1,88 @@
+//Draw and blit bandwidth of 1080p sprites, packed cg::Image pixels against the std::pair storage they replaced
+//The pair versions are the per pixel loops of draw() and blendImage() from before the change, on 8 byte pixels
+//The packed versions are timed with the SIMD kernels off as well, so the storage gain can be told apart from the vectorisation
+#include "BenchCommon.hpp"
+
+typedef std::vector<std::pair<uint32, uint8>> PairPixels;
+
+static PairPixels ToPairs(const cg::Image& image)
+{
+	return PairPixels(image.getPixelData(), image.getPixelData() + (image.getWidth() * image.getHeight()));
+}
+
+//ConsoleGraphics::draw() on pair pixels: a bounds check and a blendPixel() per pixel
+static void PairDraw(uint32* buffer, uint32 bufferWidth, uint32 bufferHeight, const PairPixels& image, uint32 width, uint32 height, uint32 posX, uint32 posY)
+{
+	for (uint32 y = 0; y < height; ++y)
+	{
+		for (uint32 x = 0; x < width; ++x)
+		{
+			const uint32 dstX = x + posX, dstY = y + posY;
+			if (dstX < bufferWidth && dstY < bufferHeight)
+			{
+				const std::pair<uint32, uint8>& src = image[(y * width) + x];
+				if (src.second == 255){buffer[(dstY * bufferWidth) + dstX] = src.first;
+				}
+				else if (src.second != 0){buffer[(dstY * bufferWidth) + dstX] = cg::blendPixel(buffer[(dstY * bufferWidth) + dstX], src.first, src.second);
+				}
+			}
+			else if (dstY >= bufferHeight){return;
+			}
+			else if (dstX >= bufferWidth){break;
+			}
+		}
+	}
+	return;
+}
+
+//Image::blendImage() on pair pixels, keeping the destination alpha
+static void PairBlendImage(PairPixels& dst, uint32 dstWidth, uint32 dstHeight, const PairPixels& src, uint32 srcWidth, uint32 srcHeight)
+{
+	for (uint32 y = 0; y < srcHeight; ++y)
+	{
+		for (uint32 x = 0; x < srcWidth; ++x)
+		{
+			if (x < dstWidth && y < dstHeight)
+			{
+				std::pair<uint32, uint8>& d = dst[(y * dstWidth) + x];
+				const std::pair<uint32, uint8>& s = src[(y * srcWidth) + x];
+				d.first = cg::blendPixel(d.first, s.first, s.second);
+			}
+		}
+	}
+	return;
+}
+
+int main(void)
+{
+	const uint32 width = 1920, height = 1080, repeats = 20;
+	const double count = (double)width * height;
+	cg::MemoryBackend backend;
+	cg::ConsoleGraphics graphics(width, height, &backend);
+	graphics.enableAlpha();
+	std::vector<uint32> pairBuffer(width * height, 0);
+	cg::Image background = bench::RandomImage(width, height, true);
+	PairPixels pairBackground = ToPairs(background);
+
+	for (bool opaque : {true, false})
+	{
+		cg::Image sprite = bench::RandomImage(width, height, opaque);
+		const PairPixels pairSprite = ToPairs(sprite);
+		std::printf("%s %ux%u sprite\n", opaque ? "Opaque" : "Translucent", width, height);
+
+		bench::Report("draw(), pair pixels", bench::Time(repeats, [&](){PairDraw(pairBuffer.data(), width, height, pairSprite, width, height, 0, 0);}), count);
+		cg::blend::UseSIMD() = false;
+		bench::Report("draw(), packed pixels, scalar", bench::Time(repeats, [&](){graphics.draw(sprite);}), count);
+		cg::blend::UseSIMD() = true;
+		bench::Report("draw(), packed pixels, SIMD", bench::Time(repeats, [&](){graphics.draw(sprite);}), count);
+
+		bench::Report("blendImage(), pair pixels", bench::Time(repeats, [&](){PairBlendImage(pairBackground, width, height, pairSprite, width, height);}), count);
+		cg::blend::UseSIMD() = false;
+		bench::Report("blendImage(), packed pixels, scalar", bench::Time(repeats, [&](){background.blendImage(sprite, 0, 0, 0, 0, width, height);}), count);
+		cg::blend::UseSIMD() = true;
+		bench::Report("blendImage(), packed pixels, SIMD", bench::Time(repeats, [&](){background.blendImage(sprite, 0, 0, 0, 0, width, height);}), count);
+	}
+	bench::Use(pairBuffer[12345] + pairBackground[12345].first + graphics.getPixelData()[12345] + background.getPixelData()[12345].getARGB());
+	std::printf("Pixels are %u bytes packed and %u bytes as pairs\n", (uint32)sizeof(cg::Pixel), (uint32)sizeof(std::pair<uint32, uint8>));
+	return 0;
+}
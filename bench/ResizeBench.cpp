@@ -0,0 +1,44 @@
+//Image::resize() throughput of the filtered interpolation methods, scaling 1080p up and down on one thread and on the thread pool
+//Throughput is in millions of output pixels a second
+#include "BenchCommon.hpp"
+
+struct Method
+{
+	const char* name;
+	cg::InterpolationMethod method;
+};
+
+int main(void)
+{
+	const Method methods[] = {{"Bilinear", cg::InterpolationMethod::Bilinear}, {"CatmullRom", cg::InterpolationMethod::CatmullRom},
+		{"Mitchell", cg::InterpolationMethod::Mitchell}, {"Lanczos3", cg::InterpolationMethod::Lanczos3}};
+	const struct {uint32 srcWidth, srcHeight, dstWidth, dstHeight;} sizes[] = {{960, 540, 1920, 1080}, {1920, 1080, 640, 360}};
+	uint32 checksum = 0;
+	for (const auto& size : sizes)
+	{
+		const cg::Image source = bench::RandomImage(size.srcWidth, size.srcHeight, false);
+		const double pixels = (double)size.dstWidth * size.dstHeight;
+		//resize() works in place, so every run resizes a fresh copy and the time of the copy is taken off
+		const double copy = bench::Time(10, [&](){cg::Image image = source; checksum += image.getPixelData()[0].getARGB();});
+		std::printf("%ux%u to %ux%u (MPix/s)\n", size.srcWidth, size.srcHeight, size.dstWidth, size.dstHeight);
+		std::printf("  %-12s %10s %10s\n", "method", "sequential", "parallel");
+		for (const Method& m : methods)
+		{
+			double seconds[2];
+			for (uint32 parallel = 0; parallel < 2; ++parallel)
+			{
+				const cg::ExecutionPolicy policy = parallel == 1 ? cg::ExecutionPolicy::Parallel : cg::ExecutionPolicy::Sequential;
+				seconds[parallel] = bench::Time(5, [&]()
+				{
+					cg::Image image = source;
+					image.resize(size.dstWidth, size.dstHeight, m.method, policy);
+					checksum += image.getPixelData()[12345].getARGB();
+				}) - copy;
+			}
+			std::printf("  %-12s %10.1f %10.1f\n", m.name, pixels / seconds[0] / 1e6, pixels / seconds[1] / 1e6);
+		}
+	}
+	std::printf("%u threads in the shared pool\n", cg::ThreadPool::getShared().getThreadCount());
+	bench::Use(checksum);
+	return 0;
+}
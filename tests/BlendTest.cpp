@@ -0,0 +1,131 @@
+//Alpha blending: blendPixel() against plain division and the SIMD kernels against the scalar ones
+#include "TestCommon.hpp"
+
+//Every colour and alpha value, each channel is checked against (dst * (255 - a) + src * a) / 255
+static void TestBlendPixel(void)
+{
+	bool exact = true, topByteClear = true;
+	for (uint32 a = 0; a < 256; ++a)
+	{
+		for (uint32 d = 0; d < 256; ++d)
+		{
+			for (uint32 s = 0; s < 256; ++s)
+			{
+				const uint32 expected = ((d * (255 - a)) + (s * a)) / 255;
+				const uint32 blended = cg::blendPixel(0xFF000000 | (d << 16) | (s << 8) | d, (s << 16) | (d << 8) | s, (uint8)a);
+				const uint32 swapped = ((s * (255 - a)) + (d * a)) / 255;
+				exact = exact && blended == ((expected << 16) | (swapped << 8) | expected);
+				topByteClear = topByteClear && (blended & 0xFF000000) == 0;
+			}
+		}
+	}
+	CG_CHECK(exact);
+	CG_CHECK(topByteClear);
+	return;
+}
+
+//Runs kernel over count pixels at an unaligned offset with the SIMD versions on and off, both must write the same pixels and nothing past them
+template<typename F> static bool SameWithAndWithoutSIMD(uint32 count, F kernel)
+{
+	const uint32 offset = test::RandomInt(8), total = count + offset + 8;
+	std::vector<uint32> start(total);
+	std::vector<cg::Pixel> src(total);
+	for (uint32 i = 0; i < total; ++i)
+	{
+		start[i] = test::Random()();
+		uint32 argb = test::Random()();
+		if (i % 4 == 0){argb |= 0xFF000000;
+		}
+		else if (i % 5 == 0){argb &= 0x00FFFFFF;
+		}
+		src[i].setARGB(argb);
+	}
+	std::vector<uint32> simd = start, scalar = start;
+	cg::blend::UseSIMD() = true;
+	kernel(&simd[offset], &src[offset], count);
+	cg::blend::UseSIMD() = false;
+	kernel(&scalar[offset], &src[offset], count);
+	cg::blend::UseSIMD() = true;
+	bool untouched = true;
+	for (uint32 i = 0; i < total; ++i)
+	{
+		if (i < offset || i >= offset + count){untouched = untouched && simd[i] == start[i];
+		}
+	}
+	return untouched && simd == scalar;
+}
+
+static void TestKernels(void)
+{
+	for (uint32 t = 0; t < 2000; ++t)
+	{
+		const uint32 count = test::RandomInt(t < 1000 ? 40 : 600);
+		const uint32 rgb = test::Random()() & 0x00FFFFFF;
+		const uint8 a = t % 10 == 0 ? 255 : (t % 10 == 1 ? 0 : (uint8)test::Random()());
+		CG_CHECK(SameWithAndWithoutSIMD(count, [](uint32* dst, const cg::Pixel* src, uint32 n){cg::blendRow(dst, src, n);}));
+		CG_CHECK(SameWithAndWithoutSIMD(count, [](uint32* dst, const cg::Pixel* src, uint32 n){cg::blendRowPremultiplied(dst, src, n);}));
+		CG_CHECK(SameWithAndWithoutSIMD(count, [](uint32* dst, const cg::Pixel* src, uint32 n){cg::blendRow(reinterpret_cast<cg::Pixel*>(dst), src, n);}));
+		CG_CHECK(SameWithAndWithoutSIMD(count, [](uint32* dst, const cg::Pixel* src, uint32 n){cg::blendRowPremultiplied(reinterpret_cast<cg::Pixel*>(dst), src, n);}));
+		CG_CHECK(SameWithAndWithoutSIMD(count, [&](uint32* dst, const cg::Pixel*, uint32 n){cg::blendSpan(dst, rgb, a, n);}));
+		CG_CHECK(SameWithAndWithoutSIMD(count, [&](uint32* dst, const cg::Pixel*, uint32 n){cg::fillSpan(dst, rgb, n);}));
+	#ifdef CG_SSE2
+		//The SSE2 versions aren't picked when AVX2 is available, so they're called directly
+		using namespace cg::blend;
+		CG_CHECK(SameWithAndWithoutSIMD(count, [](uint32* dst, const cg::Pixel* src, uint32 n){(UseSIMD() ? RowSSE2 : RowScalar)(dst, src, n);}));
+		CG_CHECK(SameWithAndWithoutSIMD(count, [](uint32* dst, const cg::Pixel* src, uint32 n){(UseSIMD() ? RowPremultipliedSSE2 : RowPremultipliedScalar)(dst, src, n);}));
+		CG_CHECK(SameWithAndWithoutSIMD(count, [&](uint32* dst, const cg::Pixel*, uint32 n){(UseSIMD() ? SpanSSE2 : SpanScalar)(dst, rgb, a, n);}));
+		CG_CHECK(SameWithAndWithoutSIMD(count, [&](uint32* dst, const cg::Pixel*, uint32 n){(UseSIMD() ? FillSSE2 : FillScalar)(dst, rgb, n);}));
+	#endif
+	}
+	return;
+}
+
+//Drawing and blendImage() give the same pixels with the SIMD kernels on and off
+static void TestDrawing(void)
+{
+	const uint32 width = 157, height = 93;
+	for (uint32 t = 0; t < 30; ++t)
+	{
+		const cg::Image image = test::RandomImage(1 + test::RandomInt(120), 1 + test::RandomInt(80));
+		cg::Image premultiplied = image;
+		premultiplied.premultiplyAlpha();
+		const cg::Image background = test::RandomImage(width, height);
+		const int32 x = (int32)test::RandomInt(width + 40) - 20, y = (int32)test::RandomInt(height + 40) - 20;
+		const uint32 rectX = test::RandomInt(width), rectY = test::RandomInt(height), rgb = test::Random()() & 0x00FFFFFF;
+		const uint8 a = (uint8)test::Random()();
+
+		std::vector<uint32> results[2];
+		cg::Image blended[2];
+		for (uint32 simd = 0; simd < 2; ++simd)
+		{
+			cg::blend::UseSIMD() = simd == 1;
+			cg::MemoryBackend backend;
+			cg::ConsoleGraphics graphics(width, height, &backend);
+			cg::Image sprite = image, premultipliedSprite = premultiplied;
+			sprite.setPos(x, y);
+			premultipliedSprite.setPos(y, x);
+			graphics.draw(sprite);
+			graphics.draw(premultipliedSprite);
+			graphics.drawEX(sprite, 3, 5, rectX, rectY, 90, 70, cg::DrawType::Resize);
+			graphics.drawRectA(rectX, rectY, 70, 50, rgb, a);
+			graphics.drawPixel(rectY, rectX, rgb, a);
+			results[simd].assign(graphics.getPixelData(), graphics.getPixelData() + (width * height));
+
+			blended[simd] = background;
+			blended[simd].blendImage(sprite, rectX / 2, rectY / 2, 0, 0, sprite.getWidth(), sprite.getHeight());
+			blended[simd].blendImage(premultipliedSprite, rectY / 2, rectX / 2, 1, 1, sprite.getWidth(), sprite.getHeight(), false);
+		}
+		cg::blend::UseSIMD() = true;
+		CG_CHECK(results[0] == results[1]);
+		CG_CHECK(test::SameImage(blended[0], blended[1]));
+	}
+	return;
+}
+
+int main(void)
+{
+	TestBlendPixel();
+	TestKernels();
+	TestDrawing();
+	return test::Finish("BlendTest");
+}
@@ -0,0 +1,228 @@
+//Recorded and tiled drawing against drawing every call straight away
+#include "TestCommon.hpp"
+#include <algorithm>
+#include <functional>
+
+struct Draw
+{
+	int32 layer;
+	const cg::Image* image; //Image the call draws, nullptr for everything else
+	std::function<void(cg::ConsoleGraphics&)> call;
+};
+
+static void Tint(std::pair<uint32, uint8>* pixel, void*)
+{
+	pixel->first ^= 0x204080;
+	return;
+}
+
+//Random draw calls of every kind, many of them partly or completely outside the buffer
+static std::vector<Draw> RandomFrame(uint32 width, uint32 height, std::vector<cg::Image>& images, uint32 count, bool layers)
+{
+	std::mt19937& random = test::Random();
+	auto coord = [&](uint32 size){return (int32)(random() % (size + 80)) - 40;};
+	auto value = [&](uint32 size){return ((random() % ((size + 80) * 8)) / 8.f) - 40.f;};
+	std::vector<Draw> frame;
+	for (uint32 i = 0; i < count; ++i)
+	{
+		cg::Image& image = images[random() % images.size()];
+		const int32 x = coord(width), y = coord(height), x1 = coord(width), y1 = coord(height);
+		const float fx = value(width), fy = value(height), fx1 = value(width), fy1 = value(height), fx2 = value(width), fy2 = value(height);
+		const uint32 ux = random() % (width + 30), uy = random() % (height + 30), w = random() % 60, h = random() % 60;
+		const uint32 rgb = random() & 0x00FFFFFF, srcX = random() % 8, srcY = random() % 8;
+		const uint8 alpha = random() % 2 == 0 ? 255 : (uint8)random();
+		const bool forward = random() % 2 == 0;
+		const float angle = value(6);
+		const uint32 type = random() % 16;
+		std::function<void(cg::ConsoleGraphics&)> call;
+		switch (type)
+		{
+			case 0: call = [&image, x, y](cg::ConsoleGraphics& g){image.setPos(x, y); g.draw(image);}; break;
+			case 1: call = [&image, srcX, srcY, x, y, w, h](cg::ConsoleGraphics& g){g.drawEX(image, srcX, srcY, x, y, w, h, cg::DrawType::Repeat, Tint);}; break;
+			case 2: call = [&image, srcX, srcY, x, y, w, h](cg::ConsoleGraphics& g){g.drawEX(image, srcX, srcY, x, y, w, h, cg::DrawType::Resize);}; break;
+			case 3: call = [ux, uy, w, h, rgb](cg::ConsoleGraphics& g){g.drawRect(ux, uy, w, h, rgb, true);}; break;
+			case 4: call = [ux, uy, w, h, rgb](cg::ConsoleGraphics& g){g.drawRect(ux, uy, w, h, rgb, false);}; break;
+			case 5: call = [ux, uy, w, h, rgb, alpha](cg::ConsoleGraphics& g){g.drawRectA(ux, uy, w, h, rgb, alpha);}; break;
+			case 6: call = [ux, uy, w, rgb, forward](cg::ConsoleGraphics& g){g.lineHorizontal(ux, uy, w, rgb, forward);}; break;
+			case 7: call = [ux, uy, h, rgb, forward](cg::ConsoleGraphics& g){g.lineVertical(ux, uy, h, rgb, forward);}; break;
+			case 8: call = [x, y, x1, y1, rgb, alpha](cg::ConsoleGraphics& g){g.drawLine(x, y, x1, y1, rgb, alpha);}; break;
+			case 9: call = [fx, fy, fx1, fy1, rgb, alpha](cg::ConsoleGraphics& g){g.drawLineAA(fx, fy, fx1, fy1, rgb, alpha);}; break;
+			case 10: call = [fx, fy, w, rgb, alpha, forward](cg::ConsoleGraphics& g){g.drawCircleAA(fx, fy, w / 2.f, rgb, forward, alpha);}; break;
+			case 11: call = [fx, fy, fx1, fy1, fx2, fy2, rgb, alpha](cg::ConsoleGraphics& g){g.drawTriangle(fx, fy, fx1, fy1, fx2, fy2, rgb, alpha);}; break;
+			case 12: call = [ux, uy, rgb](cg::ConsoleGraphics& g){g.setPixel(ux, uy, rgb);}; break;
+			case 13: call = [ux, uy, rgb, alpha](cg::ConsoleGraphics& g){g.drawPixel(ux, uy, rgb, alpha);}; break;
+			case 14:
+				call = [&image, fx, fy, angle](cg::ConsoleGraphics& g)
+				{
+					cg::AffineTransform transform;
+					transform.rotate(angle).translate(fx, fy);
+					g.drawTransformed(image, transform, cg::InterpolationMethod::Bilinear);
+				};
+			break;
+			default: call = [rgb](cg::ConsoleGraphics& g){g.clear((uint8)rgb);}; break;
+		}
+		const bool drawsImage = type <= 2 || type == 14;
+		frame.push_back({layers ? (int32)(random() % 4) - 1 : 0, drawsImage ? &image : nullptr, call});
+	}
+	return frame;
+}
+
+//Whether the call is recorded, calls completely outside the buffer are dropped
+static bool IsRecorded(const Draw& draw, uint32 width, uint32 height)
+{
+	cg::MemoryBackend backend;
+	cg::ConsoleGraphics probe(width, height, &backend);
+	probe.enableCommandBuffer();
+	draw.call(probe);
+	return probe.getCommandCount() != 0;
+}
+
+//Draws the frame straight away in the order the command buffer should use
+static void DrawImmediately(cg::ConsoleGraphics& graphics, std::vector<Draw> frame, cg::CommandSort sort)
+{
+	if (sort != cg::CommandSort::None)
+	{
+		std::stable_sort(frame.begin(), frame.end(), [](const Draw& a, const Draw& b){return a.layer < b.layer;});
+	}
+	if (sort == cg::CommandSort::LayerImage)
+	{
+		//Dropped calls draw nothing and don't split runs of image draws
+		std::vector<Draw> recorded;
+		for (const Draw& draw : frame)
+		{
+			if (IsRecorded(draw, graphics.getWidth(), graphics.getHeight())){recorded.push_back(draw);
+			}
+		}
+		frame.clear();
+		//Each run of image draws in a layer is grouped by image, in the order of each image's first draw
+		for (uint32 begin = 0, end = 0; begin < recorded.size(); begin = std::max(end, begin + 1))
+		{
+			for (end = begin; end < recorded.size() && recorded[end].image != nullptr && recorded[end].layer == recorded[begin].layer; ++end)
+			{
+			}
+			if (end == begin)
+			{
+				frame.push_back(recorded[begin]);
+				continue;
+			}
+			for (uint32 i = begin; i < end; ++i)
+			{
+				bool first = true;
+				for (uint32 j = begin; j < i; ++j)
+				{
+					first = first && recorded[j].image != recorded[i].image;
+				}
+				for (uint32 j = i; j < end && first; ++j)
+				{
+					if (recorded[j].image == recorded[i].image){frame.push_back(recorded[j]);
+					}
+				}
+			}
+		}
+	}
+	for (const Draw& draw : frame)
+	{
+		draw.call(graphics);
+	}
+	return;
+}
+static void Record(cg::ConsoleGraphics& graphics, const std::vector<Draw>& frame)
+{
+	for (const Draw& draw : frame)
+	{
+		graphics.setLayer(draw.layer);
+		draw.call(graphics);
+	}
+	return;
+}
+
+static bool SameBuffers(cg::ConsoleGraphics& a, cg::ConsoleGraphics& b)
+{
+	return test::SameBuffer(a.getPixelData(), b.getPixelData(), a.getWidth() * a.getHeight());
+}
+
+//Flushing recorded commands, with and without tiles and with each kind of sorting, gives the pixels of drawing every call straight away
+static void TestFlushMatchesImmediate(void)
+{
+	cg::ThreadPool::getShared().setThreadCount(4);
+	std::vector<cg::Image> images;
+	images.push_back(test::RandomImage(30, 20));
+	images.push_back(cg::Image(17, 25, 0x3366CC, 255));
+	images.push_back(test::RandomImage(64, 9));
+	images.back().premultiplyAlpha();
+	for (uint32 tileSize : {0, 1, 7, 16, 64})
+	{
+		for (cg::CommandSort sort : {cg::CommandSort::None, cg::CommandSort::Layer, cg::CommandSort::LayerImage})
+		{
+			const bool layers = sort != cg::CommandSort::None;
+			const uint32 width = 120 + test::RandomInt(40), height = 70 + test::RandomInt(40);
+			cg::MemoryBackend immediateBackend, recordedBackend;
+			cg::ConsoleGraphics immediate(width, height, &immediateBackend), recorded(width, height, &recordedBackend);
+			recorded.setCommandSort(sort);
+			if (tileSize != 0)
+			{
+				recorded.enableTiledRendering(tileSize);
+			}
+			else {
+				recorded.enableCommandBuffer();
+			}
+			for (uint32 f = 0; f < (tileSize == 1 ? 5 : 30); ++f)
+			{
+				const std::vector<Draw> frame = RandomFrame(width, height, images, 1 + test::RandomInt(40), layers);
+				DrawImmediately(immediate, frame, sort);
+				Record(recorded, frame);
+				recorded.flushCommands();
+				CG_CHECK(SameBuffers(immediate, recorded));
+			}
+
+			//Replaying draws the last frame again
+			const std::vector<Draw> frame = RandomFrame(width, height, images, 20, layers);
+			DrawImmediately(immediate, frame, sort);
+			DrawImmediately(immediate, frame, sort);
+			Record(recorded, frame);
+			recorded.flushCommands();
+			recorded.replayCommands();
+			CG_CHECK(SameBuffers(immediate, recorded));
+		}
+	}
+	return;
+}
+
+//Outline rectangles and spans that are partly outside the buffer draw their visible part either way
+static void TestPartlyOutside(void)
+{
+	const uint32 width = 50, height = 40;
+	cg::MemoryBackend immediateBackend, recordedBackend;
+	cg::ConsoleGraphics immediate(width, height, &immediateBackend), recorded(width, height, &recordedBackend);
+	recorded.enableCommandBuffer();
+	auto draw = [&](cg::ConsoleGraphics& g)
+	{
+		g.drawRect(45, 35, 20, 20, 0xFF0000, false);
+		g.drawRect(30, 2, 30, 10, 0x00FF00, false);
+		g.drawRect(2, 30, 10, 4000000000u, 0x0000FF, false);
+		g.drawRect(4294967290u, 5, 20, 20, 0xFFFF00, false);
+		g.drawRect(4294967290u, 4294967290u, 20, 20, 0xFFFF00, true);
+		g.lineHorizontal(60, 20, 30, 0x00FFFF, false);
+		g.lineVertical(20, 45, 30, 0xFF00FF, false);
+		g.lineHorizontal(48, 25, 10, 0x808080);
+		g.lineVertical(25, 38, 10, 0x404040);
+	};
+	draw(immediate);
+	draw(recorded);
+	recorded.flushCommands();
+	CG_CHECK(SameBuffers(immediate, recorded));
+
+	const uint32* pixels = immediate.getPixelData();
+	CG_CHECK(pixels[(35 * width) + 49] == 0xFF0000 && pixels[(39 * width) + 45] == 0xFF0000);
+	CG_CHECK(pixels[(20 * width) + 31] == 0x00FFFF && pixels[(20 * width) + 49] == 0x00FFFF && pixels[(20 * width) + 30] == 0);
+	CG_CHECK(pixels[(16 * width) + 20] == 0xFF00FF && pixels[(39 * width) + 20] == 0xFF00FF && pixels[(15 * width) + 20] == 0);
+	CG_CHECK(pixels[(25 * width) + 48] == 0x808080 && pixels[(38 * width) + 25] == 0x404040);
+	return;
+}
+
+int main(void)
+{
+	TestFlushMatchesImmediate();
+	TestPartlyOutside();
+	return test::Finish("CommandBufferTest");
+}
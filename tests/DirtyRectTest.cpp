@@ -0,0 +1,156 @@
+//Dirty rectangle tracking: every change is covered and presenting only the dirty areas gives the same frames
+#include "TestCommon.hpp"
+
+//One random draw call, the same random numbers give the same call
+static void RandomDraw(cg::ConsoleGraphics& graphics, cg::Image& image, std::mt19937& random)
+{
+	const int32 w = graphics.getWidth(), h = graphics.getHeight();
+	auto coord = [&](int32 size){return (int32)(random() % (size + 60)) - 30;};
+	auto value = [&](float size){return ((random() % (uint32)((size + 60.f) * 8.f)) / 8.f) - 30.f;};
+	const uint32 rgb = random() & 0x00FFFFFF;
+	const uint8 alpha = random() % 2 == 0 ? 255 : (uint8)random();
+	switch (random() % 13)
+	{
+		case 0: image.setPos(coord(w), coord(h)); graphics.draw(image); break;
+		case 1: graphics.drawEX(image, random() % 10, random() % 10, coord(w), coord(h), random() % 70, random() % 50, cg::DrawType::Repeat); break;
+		case 2: graphics.drawEX(image, random() % 10, random() % 10, coord(w), coord(h), random() % 70, random() % 50, cg::DrawType::Resize); break;
+		case 3: graphics.drawRect(random() % w, random() % h, random() % 40, random() % 40, rgb, true); break;
+		case 4: graphics.drawRect(random() % w, random() % h, random() % 40, random() % 40, rgb, false); break;
+		case 5: graphics.drawRectA(random() % w, random() % h, random() % 40, random() % 40, rgb, alpha); break;
+		case 6: graphics.drawLine(coord(w), coord(h), coord(w), coord(h), rgb, alpha); break;
+		case 7: graphics.drawLineAA(value(w), value(h), value(w), value(h), rgb, alpha); break;
+		case 8: graphics.drawCircleAA(value(w), value(h), value(20.f), rgb, random() % 2 == 0, alpha); break;
+		case 9: graphics.setPixel(random() % w, random() % h, rgb); break;
+		case 10: graphics.drawPixel(random() % w, random() % h, rgb, alpha); break;
+		case 11: graphics.drawTriangle(value(w), value(h), value(w), value(h), value(w), value(h), rgb, alpha); break;
+		default: if (random() % 8 == 0){graphics.clear((uint8)random());
+		}
+		break;
+	}
+	return;
+}
+
+//Idempotent, so shading an unchanged pixel again doesn't change it
+static void Grey(uint32* pixel, uint32, uint32, uint32, uint32, void*)
+{
+	const uint32 v = (((*pixel >> 16) & 0xFF) + ((*pixel >> 8) & 0xFF) + (*pixel & 0xFF)) / 3;
+	*pixel = (v << 16) | (v << 8) | v;
+	return;
+}
+
+static bool Contains(const cg::Rect& r, uint32 x, uint32 y)
+{
+	return x >= r.x && x < r.right() && y >= r.y && y < r.bottom();
+}
+
+//Every pixel a draw call changes is inside one of the dirty rectangles, which stay disjoint, inside the buffer and at most 8
+static void TestCoverage(void)
+{
+	const uint32 width = 110, height = 70;
+	cg::MemoryBackend backend;
+	cg::ConsoleGraphics graphics(width, height, &backend);
+	graphics.enableDirtyRects();
+	graphics.display();
+	cg::Image image = test::RandomImage(33, 21);
+	std::mt19937 random(5);
+	for (uint32 frame = 0; frame < 400; ++frame)
+	{
+		std::vector<uint32> before(graphics.getPixelData(), graphics.getPixelData() + (width * height));
+		const uint32 calls = 1 + (random() % 6);
+		for (uint32 i = 0; i < calls; ++i)
+		{
+			RandomDraw(graphics, image, random);
+		}
+		const std::vector<cg::Rect>& rects = graphics.getDirtyRects();
+		bool covered = true, disjoint = true, inside = rects.size() <= 8;
+		for (uint32 y = 0; y < height; ++y)
+		{
+			for (uint32 x = 0; x < width; ++x)
+			{
+				if (((before[(y * width) + x] ^ graphics.getPixelData()[(y * width) + x]) & 0x00FFFFFF) == 0){continue;
+				}
+				bool found = false;
+				for (const cg::Rect& r : rects)
+				{
+					found = found || Contains(r, x, y);
+				}
+				covered = covered && found;
+			}
+		}
+		for (uint32 a = 0; a < rects.size(); ++a)
+		{
+			inside = inside && rects[a].width != 0 && rects[a].height != 0 && rects[a].right() <= width && rects[a].bottom() <= height;
+			for (uint32 b = a + 1; b < rects.size(); ++b)
+			{
+				disjoint = disjoint && (rects[a].right() <= rects[b].x || rects[b].right() <= rects[a].x || rects[a].bottom() <= rects[b].y || rects[b].bottom() <= rects[a].y);
+			}
+		}
+		CG_CHECK(covered);
+		CG_CHECK(disjoint);
+		CG_CHECK(inside);
+		graphics.display();
+	}
+	return;
+}
+
+//Presenting only the dirty areas (with shaders, synchronously and asynchronously) gives the same frames as presenting everything
+static void TestPresentMatchesFullFrames(void)
+{
+	const uint32 width = 97, height = 64;
+	for (uint32 buffers : {0, 2, 3})
+	{
+		cg::MemoryBackend fullBackend(true), dirtyBackend(true);
+		cg::ConsoleGraphics full(width, height, &fullBackend), dirty(width, height, &dirtyBackend);
+		dirty.enableDirtyRects();
+		if (buffers != 0){dirty.enableAsyncPresent(buffers);
+		}
+		full.loadPPShader(Grey);
+		dirty.loadPPShader(Grey);
+		cg::Image fullImage = test::RandomImage(25, 19), dirtyImage = fullImage;
+		std::mt19937 fullRandom(77), dirtyRandom(77);
+		for (uint32 frame = 0; frame < 150; ++frame)
+		{
+			const uint32 calls = frame % 10 == 0 ? 0 : 1 + (frame % 4);
+			for (uint32 i = 0; i < calls; ++i)
+			{
+				RandomDraw(full, fullImage, fullRandom);
+				RandomDraw(dirty, dirtyImage, dirtyRandom);
+			}
+			full.display();
+			dirty.display();
+			if (buffers != 0){dirty.waitForPresent();
+			}
+			CG_CHECK(test::SameBuffer(fullBackend.getCapturedFrame(), dirtyBackend.getCapturedFrame(), width * height));
+		}
+	}
+	return;
+}
+
+static void TestRedrawFraction(void)
+{
+	cg::MemoryBackend backend;
+	cg::ConsoleGraphics graphics(100, 100, &backend);
+	graphics.display();
+	CG_CHECK(graphics.getRedrawFraction() == 1.f);
+	graphics.enableDirtyRects();
+	graphics.display();
+	CG_CHECK(graphics.getRedrawFraction() == 1.f);
+	graphics.display();
+	CG_CHECK(graphics.getRedrawFraction() == 0.f);
+	graphics.drawRect(10, 20, 10, 10, 0xFFFFFF);
+	graphics.drawRect(80, 80, 5, 4, 0xFFFFFF);
+	graphics.display();
+	CG_CHECK(graphics.getRedrawFraction() == 0.012f);
+	graphics.drawRect(95, 95, 50, 50, 0xFFFFFF);
+	graphics.display();
+	CG_CHECK(graphics.getRedrawFraction() == 0.0025f);
+	return;
+}
+
+int main(void)
+{
+	TestCoverage();
+	TestPresentMatchesFullFrames();
+	TestRedrawFraction();
+	return test::Finish("DirtyRectTest");
+}
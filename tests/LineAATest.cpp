@@ -0,0 +1,181 @@
+//Anti-aliased lines and circles against a floating point Wu line, clipped drawing and the scalar row blend
+#include "TestCommon.hpp"
+#include <cmath>
+
+static bool Near(uint32 a, uint32 b, uint32 tolerance)
+{
+	for (uint32 c = 0; c < 24; c += 8)
+	{
+		if (std::abs((int32)((a >> c) & 0xFF) - (int32)((b >> c) & 0xFF)) > (int32)tolerance){return false;
+		}
+	}
+	return true;
+}
+static bool NearBuffer(const uint32* a, const uint32* b, uint32 count, uint32 tolerance)
+{
+	for (uint32 i = 0; i < count; ++i)
+	{
+		if (!Near(a[i], b[i], tolerance)){return false;
+		}
+	}
+	return true;
+}
+
+//Xiaolin Wu's line in doubles with the same conventions: pixel centres at integers, partly covered end pixels
+static void ReferenceLineAA(std::vector<uint32>& buffer, uint32 width, double x0, double y0, double x1, double y1, uint32 rgb, uint8 alpha)
+{
+	const bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
+	if (steep)
+	{
+		std::swap(x0, y0);
+		std::swap(x1, y1);
+	}
+	if (x0 > x1)
+	{
+		std::swap(x0, x1);
+		std::swap(y0, y1);
+	}
+	auto plot = [&](double major, double minor, double coverage)
+	{
+		const uint32 x = (uint32)(steep ? minor : major), y = (uint32)(steep ? major : minor);
+		buffer[(y * width) + x] = cg::blendPixel(buffer[(y * width) + x], rgb, (uint8)(coverage * alpha));
+	};
+	auto fpart = [](double v){return v - std::floor(v);};
+	const double gradient = x1 - x0 < 1.0 / 65536.0 ? 1.0 : (y1 - y0) / (x1 - x0);
+
+	const double xEnd0 = std::floor(x0 + 0.5), xEnd1 = std::floor(x1 + 0.5);
+	const double yEnd0 = y0 + (gradient * (xEnd0 - x0)), yEnd1 = y1 + (gradient * (xEnd1 - x1));
+	if (xEnd0 == xEnd1)
+	{
+		plot(xEnd0, std::floor(yEnd0), (1.0 - fpart(yEnd0)) * (x1 - x0));
+		plot(xEnd0, std::floor(yEnd0) + 1.0, fpart(yEnd0) * (x1 - x0));
+		return;
+	}
+	const double gap0 = 1.0 - fpart(x0 + 0.5), gap1 = fpart(x1 + 0.5);
+	plot(xEnd0, std::floor(yEnd0), (1.0 - fpart(yEnd0)) * gap0);
+	plot(xEnd0, std::floor(yEnd0) + 1.0, fpart(yEnd0) * gap0);
+	plot(xEnd1, std::floor(yEnd1), (1.0 - fpart(yEnd1)) * gap1);
+	plot(xEnd1, std::floor(yEnd1) + 1.0, fpart(yEnd1) * gap1);
+	double intery = yEnd0 + gradient;
+	for (double x = xEnd0 + 1.0; x < xEnd1; x += 1.0, intery += gradient)
+	{
+		plot(x, std::floor(intery), 1.0 - fpart(intery));
+		plot(x, std::floor(intery) + 1.0, fpart(intery));
+	}
+	return;
+}
+
+//Lines inside the buffer come out within a few steps of the reference, the fixed point coverage is rounded to 1 / 256
+static void TestLineAgainstReference(void)
+{
+	const uint32 width = 90, height = 70;
+	cg::MemoryBackend backend;
+	cg::ConsoleGraphics graphics(width, height, &backend);
+	for (uint32 t = 0; t < 2000; ++t)
+	{
+		const float length = t % 4 == 0 ? 2.f : 80.f;
+		const float x0 = test::RandomFloat(3.f, width - 4.f), y0 = test::RandomFloat(3.f, height - 4.f);
+		const float x1 = std::min(std::max(x0 + test::RandomFloat(-length, length), 3.f), width - 4.f);
+		const float y1 = std::min(std::max(y0 + test::RandomFloat(-length, length), 3.f), height - 4.f);
+		const uint32 rgb = test::Random()() & 0x00FFFFFF;
+		const uint8 alpha = t % 3 == 0 ? 255 : (uint8)test::Random()();
+
+		graphics.clear();
+		graphics.drawLineAA(x0, y0, x1, y1, rgb, alpha);
+		std::vector<uint32> expected(width * height, 0);
+		ReferenceLineAA(expected, width, x0, y0, x1, y1, rgb, alpha);
+		CG_CHECK(NearBuffer(expected.data(), graphics.getPixelData(), width * height, 3));
+	}
+
+	//A line along a pixel row covers it fully
+	graphics.clear();
+	graphics.drawLineAA(10.f, 20.f, 60.f, 20.f, 0xFFFFFF);
+	bool solid = true;
+	for (uint32 x = 11; x < 60; ++x)
+	{
+		solid = solid && graphics.getPixelData()[(20 * width) + x] == 0xFFFFFF && graphics.getPixelData()[(21 * width) + x] == 0;
+	}
+	CG_CHECK(solid);
+	return;
+}
+
+//Drawing into a small buffer gives the same pixels as drawing into a bigger one around it and cutting the middle out
+//Coordinates are multiples of 1 / 16 so moving them by a whole number of pixels is exact
+static void TestClipping(void)
+{
+	const uint32 width = 80, height = 60, border = 200, bigWidth = width + (2 * border), bigHeight = height + (2 * border);
+	cg::MemoryBackend smallBackend, bigBackend;
+	cg::ConsoleGraphics graphics(width, height, &smallBackend), big(bigWidth, bigHeight, &bigBackend);
+	auto random = [](float low, float high){return std::floor(test::RandomFloat(low, high) * 16.f) / 16.f;};
+	for (uint32 t = 0; t < 1500; ++t)
+	{
+		const bool circle = t % 3 == 0;
+		const uint32 rgb = test::Random()() & 0x00FFFFFF;
+		const uint8 alpha = t % 2 == 0 ? 255 : (uint8)test::Random()();
+		graphics.clear();
+		big.clear();
+		if (circle)
+		{
+			const float cx = random(-60.f, width + 60.f), cy = random(-60.f, height + 60.f), radius = random(0.f, 100.f);
+			const bool fill = t % 2 == 0;
+			graphics.drawCircleAA(cx, cy, radius, rgb, fill, alpha);
+			big.drawCircleAA(cx + border, cy + border, radius, rgb, fill, alpha);
+		}
+		else
+		{
+			const float x0 = random(-190.f, width + 190.f), y0 = random(-190.f, height + 190.f);
+			const float x1 = random(-190.f, width + 190.f), y1 = random(-190.f, height + 190.f);
+			graphics.drawLineAA(x0, y0, x1, y1, rgb, alpha);
+			big.drawLineAA(x0 + border, y0 + border, x1 + border, y1 + border, rgb, alpha);
+		}
+		std::vector<uint32> cut(width * height);
+		for (uint32 y = 0; y < height; ++y)
+		{
+			memcpy(&cut[y * width], &big.getPixelData()[((y + border) * bigWidth) + border], width * sizeof(uint32));
+		}
+		//Lines that leave the buffer are cut first, which can move the rest of the line by a fraction of a coverage step
+		CG_CHECK(NearBuffer(cut.data(), graphics.getPixelData(), width * height, circle ? 0 : 2));
+	}
+
+	//Lines far outside the buffer or with huge coordinates draw nothing and don't touch memory outside it
+	graphics.clear();
+	graphics.drawLineAA(-1e9f, -5.f, -1e8f, 30.f, 0xFFFFFF);
+	graphics.drawLineAA(20.f, -1e30f, 21.f, -1e29f, 0xFFFFFF);
+	graphics.drawLineAA(1e20f, 1e20f, 2e20f, 2e20f, 0xFFFFFF);
+	graphics.drawCircleAA(-1e6f, 30.f, 1000.f, 0xFFFFFF, true);
+	const std::vector<uint32> black(width * height, 0);
+	CG_CHECK(test::SameBuffer(black.data(), graphics.getPixelData(), width * height));
+	return;
+}
+
+//Circle rows go through blendRow(), so they must come out the same with the SIMD kernels on and off
+static void TestSIMD(void)
+{
+	const uint32 width = 150, height = 110;
+	std::vector<uint32> results[2];
+	for (uint32 simd = 0; simd < 2; ++simd)
+	{
+		cg::blend::UseSIMD() = simd == 1;
+		std::mt19937 random(99);
+		cg::MemoryBackend backend;
+		cg::ConsoleGraphics graphics(width, height, &backend);
+		for (uint32 i = 0; i < 300; ++i)
+		{
+			const float cx = (random() % 2000) / 10.f - 25.f, cy = (random() % 1600) / 10.f - 25.f, radius = (random() % 800) / 10.f;
+			graphics.drawCircleAA(cx, cy, radius, random() & 0x00FFFFFF, i % 2 == 0, (uint8)random());
+			graphics.drawLineAA(cx, cy, cy, cx, random() & 0x00FFFFFF, (uint8)random());
+		}
+		results[simd].assign(graphics.getPixelData(), graphics.getPixelData() + (width * height));
+	}
+	cg::blend::UseSIMD() = true;
+	CG_CHECK(results[0] == results[1]);
+	return;
+}
+
+int main(void)
+{
+	TestLineAgainstReference();
+	TestClipping();
+	TestSIMD();
+	return test::Finish("LineAATest");
+}
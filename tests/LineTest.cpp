@@ -0,0 +1,117 @@
+//Integer lines against a reference Bresenham line, including lines billions of pixels long that cross the buffer
+#include "TestCommon.hpp"
+
+//Step i of the line is at major0 + i, minor0 + floor(((2 * i * m) + n) / (2 * n)) with the signs of the deltas
+//Only the steps whose major coordinate is inside the buffer are visited, so very long lines are cheap
+static void ReferenceLine(std::vector<uint32>& buffer, int64 width, int64 height, int64 x0, int64 y0, int64 x1, int64 y1, uint32 rgb, uint8 alpha)
+{
+	const int64 dx = x1 - x0, dy = y1 - y0;
+	const bool steep = std::abs(dy) > std::abs(dx);
+	const int64 major0 = steep ? y0 : x0, minor0 = steep ? x0 : y0, majorSize = steep ? height : width;
+	const int64 majorSign = (steep ? dy : dx) < 0 ? -1 : 1, minorSign = (steep ? dx : dy) < 0 ? -1 : 1;
+	const uint64 n = std::abs(steep ? dy : dx), m = std::abs(steep ? dx : dy);
+	for (int64 major = 0; major < majorSize; ++major)
+	{
+		const int64 i = (major - major0) * majorSign;
+		if (i < 0 || (uint64)i > n){continue;
+		}
+		//(2 * i * m) + n needs 65 bits, so it's split into halves of i * m
+		uint64 offset = 0;
+		if (n != 0)
+		{
+			const uint64 product = (uint64)i * m, half = product / n;
+			offset = half + ((2 * (product % n)) + n >= 2 * n ? 1 : 0);
+		}
+		const int64 minor = minor0 + (minorSign * (int64)offset);
+		const int64 x = steep ? minor : major, y = steep ? major : minor;
+		if (x >= 0 && x < width && y >= 0 && y < height)
+		{
+			uint32& pixel = buffer[(y * width) + x];
+			pixel = alpha == 255 ? rgb : cg::blendPixel(pixel, rgb, alpha);
+		}
+	}
+	return;
+}
+
+static int32 RandomCoord(int64 low, int64 high)
+{
+	return (int32)(low + (int64)(((uint64)test::Random()() << 32 | test::Random()()) % (uint64)(high - low + 1)));
+}
+
+//Lines with end points around and outside the buffer, drawn clipped and through the reference
+static void TestAgainstReference(void)
+{
+	const uint32 width = 83, height = 61;
+	cg::MemoryBackend backend;
+	cg::ConsoleGraphics graphics(width, height, &backend);
+	for (uint32 t = 0; t < 20000; ++t)
+	{
+		const int64 reach = t % 2 == 0 ? 40 : 400;
+		const int32 x0 = RandomCoord(-reach, width + reach), y0 = RandomCoord(-reach, height + reach);
+		const int32 x1 = RandomCoord(-reach, width + reach), y1 = RandomCoord(-reach, height + reach);
+		const uint32 rgb = test::Random()() & 0x00FFFFFF;
+		const uint8 alpha = t % 3 == 0 ? (uint8)test::Random()() : 255;
+		graphics.clear();
+		graphics.drawLine(x0, y0, x1, y1, rgb, alpha);
+		std::vector<uint32> expected(width * height, 0);
+		ReferenceLine(expected, width, height, x0, y0, x1, y1, rgb, alpha);
+		CG_CHECK(test::SameBuffer(expected.data(), graphics.getPixelData(), width * height));
+	}
+	return;
+}
+
+//Lines up to the whole int32 range long that pass through the buffer draw exactly the pixels of the unclipped line
+static void TestLongLines(void)
+{
+	const uint32 width = 97, height = 73;
+	const int64 low = -2147483647 - 1, high = 2147483647;
+	cg::MemoryBackend backend;
+	cg::ConsoleGraphics graphics(width, height, &backend);
+	uint32 drawn = 0;
+	for (uint32 t = 0; t < 3000; ++t)
+	{
+		//Both end points are pushed out from a point inside the buffer along roughly opposite directions
+		const int64 px = test::RandomInt(width), py = test::RandomInt(height);
+		const int64 scale = t % 3 == 0 ? 1000 : (t % 3 == 1 ? 1 << 28 : high);
+		const float slope = test::RandomFloat(-3.f, 3.f), stretch = test::RandomFloat(0.2f, 1.f);
+		const int64 ax = RandomCoord(0, scale), bx = (int64)(ax * stretch) + RandomCoord(-3, 3);
+		const int64 ay = (int64)(ax * slope), by = (int64)(bx * slope) + RandomCoord(-3, 3);
+		const bool swap = t % 4 < 2;
+		int64 x0 = std::min(std::max(px - ax, low), high), y0 = std::min(std::max(py - ay, low), high);
+		int64 x1 = std::min(std::max(px + bx, low), high), y1 = std::min(std::max(py + by, low), high);
+		if (swap)
+		{
+			std::swap(x0, y0);
+			std::swap(x1, y1);
+		}
+		const uint32 rgb = 0x00FFFFFF & (test::Random()() | 1);
+		graphics.clear();
+		graphics.drawLine((int32)x0, (int32)y0, (int32)x1, (int32)y1, rgb);
+		std::vector<uint32> expected(width * height, 0);
+		ReferenceLine(expected, width, height, x0, y0, x1, y1, rgb, 255);
+		CG_CHECK(test::SameBuffer(expected.data(), graphics.getPixelData(), width * height));
+		for (uint32 i = 0; i < width * height; ++i)
+		{
+			drawn += expected[i] != 0 ? 1 : 0;
+		}
+	}
+	//Most of the lines have to reach the buffer for the test to mean anything
+	CG_CHECK(drawn > 3000 * 20);
+
+	//The longest lines there are, corner to corner of the int32 range
+	graphics.clear();
+	graphics.drawLine(-2147483647 - 1, -2147483647 - 1, 2147483647, 2147483647, 0xFFFFFF);
+	graphics.drawLine(2147483647, -2147483647 - 1, -2147483647 - 1, 2147483647, 0x00FF00);
+	std::vector<uint32> expected(width * height, 0);
+	ReferenceLine(expected, width, height, low, low, high, high, 0xFFFFFF, 255);
+	ReferenceLine(expected, width, height, high, low, low, high, 0x00FF00, 255);
+	CG_CHECK(test::SameBuffer(expected.data(), graphics.getPixelData(), width * height));
+	return;
+}
+
+int main(void)
+{
+	TestAgainstReference();
+	TestLongLines();
+	return test::Finish("LineTest");
+}
@@ -0,0 +1,82 @@
+//cg::MemoryBackend frame capture and callbacks
+#include "TestCommon.hpp"
+
+static bool NoTopByte(const uint32* pixels, uint32 count)
+{
+	for (uint32 i = 0; i < count; ++i)
+	{
+		if ((pixels[i] & 0xFF000000) != 0){return false;
+		}
+	}
+	return true;
+}
+
+struct CallbackFrame
+{
+	std::vector<uint32> pixels;
+	uint64 frames = 0;
+};
+static void StoreFrame(const uint32* pixels, uint32 width, uint32 height, uint64, void* data)
+{
+	CallbackFrame* frame = (CallbackFrame*)data;
+	frame->pixels.assign(pixels, pixels + (width * height));
+	++frame->frames;
+	return;
+}
+
+//Copied image rows put the image's alpha in the buffer's top byte, captured frames are still 0x00RRGGBB
+static void TestCapturedFramesAreRGB(void)
+{
+	const uint32 width = 80, height = 60;
+	cg::MemoryBackend backend(true);
+	CallbackFrame callbackFrame;
+	backend.setFrameCallback(StoreFrame, &callbackFrame);
+	cg::ConsoleGraphics graphics(width, height, &backend);
+	graphics.disableAlpha();
+	cg::Image image(30, 20, 0x336699, 255);
+	image.setPos(10, 10);
+	graphics.draw(image);
+	graphics.drawEX(image, 0, 0, 40, 30, 35, 25, cg::DrawType::Resize);
+	CG_CHECK(graphics.display());
+
+	CG_CHECK(backend.getCapturedFrame() != nullptr);
+	CG_CHECK(NoTopByte(backend.getCapturedFrame(), width * height));
+	CG_CHECK(backend.getCapturedFrame()[(15 * width) + 15] == 0x336699);
+	CG_CHECK(callbackFrame.frames == 1);
+	CG_CHECK(test::SameBuffer(callbackFrame.pixels.data(), backend.getCapturedFrame(), width * height));
+	CG_CHECK(test::SameBuffer(backend.getCapturedFrame(), graphics.getPixelData(), width * height, 0x00FFFFFF));
+	return;
+}
+
+//With dirty rectangles only the changed parts are copied, the capture still matches the whole buffer, also after capturing was turned off for a while
+static void TestDirtyCapture(void)
+{
+	const uint32 width = 97, height = 61;
+	cg::MemoryBackend backend(true);
+	cg::ConsoleGraphics graphics(width, height, &backend);
+	graphics.enableDirtyRects();
+	cg::Image image(9, 7, 0xA0B0C0, 200);
+	for (uint32 frame = 0; frame < 40; ++frame)
+	{
+		backend.setCapture(frame < 10 || frame > 14);
+		for (uint32 i = 0; i < 3; ++i)
+		{
+			graphics.drawRect(test::RandomInt(width), test::RandomInt(height), test::RandomInt(20), test::RandomInt(20), test::Random()());
+		}
+		image.setPos(test::RandomInt(width), test::RandomInt(height));
+		graphics.draw(image);
+		graphics.display();
+		if (frame < 10 || frame > 14)
+		{
+			CG_CHECK(test::SameBuffer(backend.getCapturedFrame(), graphics.getPixelData(), width * height, 0x00FFFFFF));
+		}
+	}
+	return;
+}
+
+int main(void)
+{
+	TestCapturedFramesAreRGB();
+	TestDirtyCapture();
+	return test::Finish("MemoryBackendTest");
+}
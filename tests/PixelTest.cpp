@@ -0,0 +1,145 @@
+//cg::Pixel packed storage against the std::pair<uint32, uint8> pixels it replaced
+#include "TestCommon.hpp"
+
+typedef std::pair<uint32, uint8> PairPixel;
+
+//The blend the pair based draw functions used
+static uint32 PairBlend(uint32 dstRGB, uint32 srcRGB, uint8 srcA)
+{
+	uint32 rgb = 0;
+	for (uint32 c = 0; c < 24; c += 8)
+	{
+		rgb |= (((((dstRGB >> c) & 0xFF) * (255 - srcA)) + (((srcRGB >> c) & 0xFF) * srcA)) / 255) << c;
+	}
+	return rgb;
+}
+static void PairDrawPixel(uint32& dst, const PairPixel& pixel, bool alphaMode)
+{
+	if (pixel.second == 255 || !alphaMode){dst = pixel.first;
+	}
+	else if (pixel.second != 0){dst = PairBlend(dst, pixel.first, pixel.second);
+	}
+	return;
+}
+
+static std::vector<PairPixel> RandomPairs(uint32 count)
+{
+	std::vector<PairPixel> pairs(count);
+	for (uint32 i = 0; i < count; ++i)
+	{
+		const uint32 argb = test::Random()();
+		pairs[i] = PairPixel(argb & 0x00FFFFFF, i % 3 == 0 ? 255 : (i % 7 == 0 ? 0 : argb >> 24));
+	}
+	return pairs;
+}
+
+static void TestLayout(void)
+{
+	CG_CHECK(sizeof(cg::Pixel) == sizeof(uint32));
+	const cg::Pixel pixel(0x123456, 0x78);
+	uint32 argb;
+	memcpy(&argb, &pixel, sizeof(uint32));
+	CG_CHECK(argb == 0x78123456);
+	CG_CHECK(pixel.getARGB() == 0x78123456);
+
+	const PairPixel pair = pixel;
+	CG_CHECK(pair.first == 0x123456 && pair.second == 0x78);
+	CG_CHECK(cg::Pixel(PairPixel(0xFF123456, 9)).getARGB() == 0x09123456);
+
+	//Images loaded from pairs, packed pixels and 0xAARRGGBB values hold the same pixels
+	const std::vector<PairPixel> pairs = RandomPairs(37 * 23);
+	std::vector<uint32> packed(pairs.size());
+	for (uint32 i = 0; i < pairs.size(); ++i)
+	{
+		packed[i] = pairs[i].first | ((uint32)pairs[i].second << 24);
+	}
+	const cg::Image fromPairs(pairs.data(), 37, 23), fromARGB(packed.data(), 37, 23, true);
+	CG_CHECK(test::SameImage(fromPairs, fromARGB));
+	bool same = true;
+	for (uint32 i = 0; i < pairs.size(); ++i)
+	{
+		same = same && fromPairs.getPixelData()[i].first == pairs[i].first && fromPairs.getPixelData()[i].second == pairs[i].second;
+	}
+	CG_CHECK(same);
+	return;
+}
+
+static void Tint(PairPixel* pixel, void*)
+{
+	pixel->first = (pixel->first ^ 0x0F0F0F) + 3;
+	pixel->second = (pixel->second >> 1) + 64;
+	return;
+}
+static void TintPacked(cg::Pixel* pixel, void*)
+{
+	PairPixel pair = *pixel;
+	Tint(&pair, nullptr);
+	*pixel = pair;
+	return;
+}
+
+//Custom filters see the same pixels through either callback type
+static void TestFilterCallbacks(void)
+{
+	const cg::Image source = test::RandomImage(61, 44);
+	cg::Image a = source, b = source;
+	a.filter(cg::FilterType::Custom, Tint);
+	b.filter(TintPacked);
+	CG_CHECK(test::SameImage(a, b));
+	return;
+}
+
+//draw() and drawEX() give what the pair based versions gave, apart from the buffer's unused top byte
+static void TestDrawMatchesPairs(void)
+{
+	const uint32 width = 120, height = 90;
+	cg::MemoryBackend backend;
+	cg::ConsoleGraphics graphics(width, height, &backend);
+	for (uint32 t = 0; t < 60; ++t)
+	{
+		const bool alphaMode = t % 2 == 0;
+		if (alphaMode){graphics.enableAlpha();
+		}
+		else graphics.disableAlpha();
+		const uint32 imageWidth = 1 + test::RandomInt(70), imageHeight = 1 + test::RandomInt(50);
+		const std::vector<PairPixel> pairs = RandomPairs(imageWidth * imageHeight);
+		cg::Image image(pairs.data(), imageWidth, imageHeight);
+		const uint32 posX = test::RandomInt(width), posY = test::RandomInt(height);
+		std::vector<uint32> expected(graphics.getPixelData(), graphics.getPixelData() + (width * height));
+
+		image.setPos(posX, posY);
+		graphics.draw(image);
+		for (uint32 y = 0; y < imageHeight && posY + y < height; ++y)
+		{
+			for (uint32 x = 0; x < imageWidth && posX + x < width; ++x)
+			{
+				PairDrawPixel(expected[((posY + y) * width) + posX + x], pairs[(y * imageWidth) + x], alphaMode);
+			}
+		}
+		CG_CHECK(test::SameBuffer(expected.data(), graphics.getPixelData(), width * height, 0x00FFFFFF));
+
+		//Tiled with a callback
+		const uint32 srcX = test::RandomInt(imageWidth), srcY = test::RandomInt(imageHeight);
+		const uint32 dstX = test::RandomInt(width), dstY = test::RandomInt(height), drawWidth = test::RandomInt(150), drawHeight = test::RandomInt(120);
+		graphics.drawEX(image, srcX, srcY, dstX, dstY, drawWidth, drawHeight, cg::DrawType::Repeat, Tint);
+		for (uint32 dy = 0; dy < drawHeight && dstY + dy < height; ++dy)
+		{
+			for (uint32 dx = 0; dx < drawWidth && dstX + dx < width; ++dx)
+			{
+				PairPixel pixel = pairs[(((srcY + dy) % imageHeight) * imageWidth) + ((srcX + dx) % imageWidth)];
+				Tint(&pixel, nullptr);
+				PairDrawPixel(expected[((dstY + dy) * width) + dstX + dx], pixel, alphaMode);
+			}
+		}
+		CG_CHECK(test::SameBuffer(expected.data(), graphics.getPixelData(), width * height, 0x00FFFFFF));
+	}
+	return;
+}
+
+int main(void)
+{
+	TestLayout();
+	TestFilterCallbacks();
+	TestDrawMatchesPairs();
+	return test::Finish("PixelTest");
+}
@@ -0,0 +1,250 @@
+//Image::resize() resamplers against straightforward reference versions and their scalar code paths
+#include "TestCommon.hpp"
+#include <cmath>
+
+//Box filter average of the source area under one destination pixel, done in doubles over every source pixel
+static cg::Pixel ReferenceArea(const cg::Image& image, uint32 x, uint32 y, uint32 newWidth, uint32 newHeight)
+{
+	const double x0 = (double)x * image.getWidth() / newWidth, x1 = (double)(x + 1) * image.getWidth() / newWidth;
+	const double y0 = (double)y * image.getHeight() / newHeight, y1 = (double)(y + 1) * image.getHeight() / newHeight;
+	double sum[3] = {0.0, 0.0, 0.0}, alpha = 0.0, area = 0.0;
+	for (uint32 sy = (uint32)y0; sy < y1; ++sy)
+	{
+		for (uint32 sx = (uint32)x0; sx < x1; ++sx)
+		{
+			const double w = (std::min<double>(sx + 1, x1) - std::max<double>(sx, x0)) * (std::min<double>(sy + 1, y1) - std::max<double>(sy, y0));
+			const uint32 argb = image.getPixelData()[(sy * image.getWidth()) + sx].getARGB();
+			const double a = argb >> 24;
+			for (uint32 c = 0; c < 3; ++c)
+			{
+				sum[c] += ((argb >> (c * 8)) & 0xFF) * a * w;
+			}
+			alpha += a * w;
+			area += w;
+		}
+	}
+	uint32 colour[3];
+	for (uint32 c = 0; c < 3; ++c)
+	{
+		colour[c] = alpha == 0.0 ? 0 : (uint32)std::min((sum[c] / alpha) + 0.5, 255.0);
+	}
+	return cg::Pixel(cg::BGR(colour[2], colour[1], colour[0]), (uint8)std::min((alpha / area) + 0.5, 255.0));
+}
+
+static bool Near(uint32 a, uint32 b, uint32 tolerance)
+{
+	for (uint32 c = 0; c < 32; c += 8)
+	{
+		if (std::abs((int32)((a >> c) & 0xFF) - (int32)((b >> c) & 0xFF)) > (int32)tolerance){return false;
+		}
+	}
+	return true;
+}
+
+//Shrinking a solid image keeps its colour however many source pixels each destination pixel covers
+static void TestAreaLargeDownscale(void)
+{
+	const uint32 sizes[][4] = {{300, 300, 1, 1}, {1024, 1024, 1, 1}, {2048, 2048, 4, 4}, {4000, 3000, 3, 1}, {1, 70000, 1, 1}};
+	for (const auto& size : sizes)
+	{
+		for (uint8 alpha : {255, 128})
+		{
+			cg::Image image(size[0], size[1], 0x804020, alpha);
+			image.resize(size[2], size[3], cg::InterpolationMethod::AreaAveraging);
+			bool solid = true;
+			for (uint32 i = 0; i < size[2] * size[3]; ++i)
+			{
+				solid = solid && image.getPixelData()[i].first == 0x804020 && image.getPixelData()[i].second == alpha;
+			}
+			CG_CHECK(solid);
+		}
+	}
+	return;
+}
+
+static void TestAreaAgainstReference(void)
+{
+	for (uint32 t = 0; t < 40; ++t)
+	{
+		const uint32 width = 1 + test::RandomInt(120), height = 1 + test::RandomInt(120);
+		const uint32 newWidth = 1 + test::RandomInt(width), newHeight = 1 + test::RandomInt(height);
+		const cg::Image source = test::RandomImage(width, height);
+		cg::Image image = source;
+		image.resize(newWidth, newHeight, cg::InterpolationMethod::AreaAveraging);
+		bool near = true;
+		for (uint32 y = 0; y < newHeight; ++y)
+		{
+			for (uint32 x = 0; x < newWidth; ++x)
+			{
+				near = near && Near(image.getPixelData()[(y * newWidth) + x].getARGB(), ReferenceArea(source, x, y, newWidth, newHeight).getARGB(), 1);
+			}
+		}
+		CG_CHECK(near);
+	}
+	return;
+}
+
+//The filter kernels written out in doubles, x is the distance from the sample in source pixels
+static double ReferenceKernel(cg::InterpolationMethod m, double x)
+{
+	const double pi = 3.14159265358979;
+	x = std::abs(x);
+	if (m == cg::InterpolationMethod::Lanczos3)
+	{
+		return x < 1e-9 ? 1.0 : (x < 3.0 ? (3.0 * std::sin(pi * x) * std::sin(pi * x / 3.0)) / (pi * pi * x * x) : 0.0);
+	}
+	const double b = m == cg::InterpolationMethod::Mitchell ? 1.0 / 3.0 : 0.0, c = m == cg::InterpolationMethod::Mitchell ? 1.0 / 3.0 : 0.5;
+	if (x < 1.0){return (((12.0 - (9.0 * b) - (6.0 * c)) * x * x * x) + ((-18.0 + (12.0 * b) + (6.0 * c)) * x * x) + (6.0 - (2.0 * b))) / 6.0;
+	}
+	if (x < 2.0){return (((-b - (6.0 * c)) * x * x * x) + (((6.0 * b) + (30.0 * c)) * x * x) + (((-12.0 * b) - (48.0 * c)) * x) + ((8.0 * b) + (24.0 * c))) / 6.0;
+	}
+	return 0.0;
+}
+//Normalised weights of every source pixel for one destination pixel, edge pixels are repeated past the border
+static std::vector<double> ReferenceWeights(cg::InterpolationMethod m, uint32 i, uint32 srcSize, uint32 dstSize)
+{
+	const double scale = (double)srcSize / dstSize, filterScale = std::max(scale, 1.0);
+	const double support = (m == cg::InterpolationMethod::Lanczos3 ? 3.0 : 2.0) * filterScale, centre = ((i + 0.5) * scale) - 0.5;
+	std::vector<double> weights(srcSize, 0.0);
+	double total = 0.0;
+	for (int32 s = (int32)std::floor(centre - support); s <= (int32)std::ceil(centre + support); ++s)
+	{
+		const double w = ReferenceKernel(m, (s - centre) / filterScale);
+		weights[std::min<int32>(std::max<int32>(s, 0), srcSize - 1)] += w;
+		total += w;
+	}
+	for (double& w : weights)
+	{
+		w /= total;
+	}
+	return weights;
+}
+//Separable resize in doubles, the horizontal pass is clamped to bytes like the real one
+static std::vector<uint32> ReferenceConvolution(const cg::Image& image, uint32 newWidth, uint32 newHeight, cg::InterpolationMethod m)
+{
+	const uint32 width = image.getWidth(), height = image.getHeight();
+	std::vector<double> rows(height * newWidth * 4);
+	for (uint32 x = 0; x < newWidth; ++x)
+	{
+		const std::vector<double> weights = ReferenceWeights(m, x, width, newWidth);
+		for (uint32 y = 0; y < height; ++y)
+		{
+			for (uint32 c = 0; c < 4; ++c)
+			{
+				double sum = 0.0;
+				for (uint32 s = 0; s < width; ++s)
+				{
+					sum += weights[s] * ((image.getPixelData()[(y * width) + s].getARGB() >> (c * 8)) & 0xFF);
+				}
+				rows[(((y * newWidth) + x) * 4) + c] = std::min(std::max(std::floor(sum + 0.5), 0.0), 255.0);
+			}
+		}
+	}
+	std::vector<uint32> result(newWidth * newHeight, 0);
+	for (uint32 y = 0; y < newHeight; ++y)
+	{
+		const std::vector<double> weights = ReferenceWeights(m, y, height, newHeight);
+		for (uint32 x = 0; x < newWidth; ++x)
+		{
+			for (uint32 c = 0; c < 4; ++c)
+			{
+				double sum = 0.0;
+				for (uint32 s = 0; s < height; ++s)
+				{
+					sum += weights[s] * rows[(((s * newWidth) + x) * 4) + c];
+				}
+				result[(y * newWidth) + x] |= (uint32)std::min(std::max(std::floor(sum + 0.5), 0.0), 255.0) << (c * 8);
+			}
+		}
+	}
+	return result;
+}
+
+static const cg::InterpolationMethod convolutionMethods[] = {cg::InterpolationMethod::CatmullRom, cg::InterpolationMethod::Mitchell, cg::InterpolationMethod::Lanczos3};
+
+//The 14 bit fixed point weights stay within a step of the double precision version
+static void TestConvolutionAgainstReference(void)
+{
+	for (uint32 t = 0; t < 60; ++t)
+	{
+		const uint32 width = 1 + test::RandomInt(50), height = 1 + test::RandomInt(50);
+		const uint32 newWidth = 1 + test::RandomInt(100), newHeight = 1 + test::RandomInt(100);
+		const cg::Image source = test::RandomImage(width, height);
+		for (cg::InterpolationMethod m : convolutionMethods)
+		{
+			cg::Image image = source;
+			image.resize(newWidth, newHeight, m);
+			const std::vector<uint32> expected = ReferenceConvolution(source, newWidth, newHeight, m);
+			bool near = true;
+			for (uint32 i = 0; i < newWidth * newHeight; ++i)
+			{
+				near = near && Near(image.getPixelData()[i].getARGB(), expected[i], 2);
+			}
+			CG_CHECK(near);
+		}
+	}
+	return;
+}
+
+//Resizing to the same size keeps the pixels for the interpolating kernels, solid images stay solid with any kernel and Bicubic is Catmull-Rom
+static void TestConvolutionProperties(void)
+{
+	const cg::Image source = test::RandomImage(45, 31);
+	for (cg::InterpolationMethod m : {cg::InterpolationMethod::CatmullRom, cg::InterpolationMethod::Lanczos3})
+	{
+		cg::Image image = source;
+		image.resize(45, 31, m);
+		CG_CHECK(test::SameImage(image, source));
+	}
+	for (cg::InterpolationMethod m : convolutionMethods)
+	{
+		for (uint32 size : {1, 7, 90, 400})
+		{
+			cg::Image image(23, 17, 0x3C7A11, 140);
+			image.resize(size, (size / 2) + 1, m);
+			bool solid = true;
+			for (uint32 i = 0; i < image.getWidth() * image.getHeight(); ++i)
+			{
+				solid = solid && image.getPixelData()[i].getARGB() == 0x8C3C7A11;
+			}
+			CG_CHECK(solid);
+		}
+	}
+	cg::Image bicubic = source, catmullRom = source;
+	bicubic.resize(70, 20, cg::InterpolationMethod::Bicubic);
+	catmullRom.resize(70, 20, cg::InterpolationMethod::CatmullRom);
+	CG_CHECK(test::SameImage(bicubic, catmullRom));
+	return;
+}
+
+//The SIMD and scalar versions of the separable resamplers give exactly the same pixels
+static void TestResizeSIMD(void)
+{
+	for (uint32 t = 0; t < 40; ++t)
+	{
+		const uint32 width = 1 + test::RandomInt(200), height = 1 + test::RandomInt(200);
+		const uint32 newWidth = 1 + test::RandomInt(300), newHeight = 1 + test::RandomInt(300);
+		const cg::Image source = test::RandomImage(width, height);
+		for (cg::InterpolationMethod m : {cg::InterpolationMethod::NearestNeighbor, cg::InterpolationMethod::Bilinear, cg::InterpolationMethod::AreaAveraging,
+			cg::InterpolationMethod::CatmullRom, cg::InterpolationMethod::Mitchell, cg::InterpolationMethod::Lanczos3})
+		{
+			cg::Image simd = source, scalar = source;
+			simd.resize(newWidth, newHeight, m);
+			cg::blend::UseSIMD() = false;
+			scalar.resize(newWidth, newHeight, m);
+			cg::blend::UseSIMD() = true;
+			CG_CHECK(test::SameImage(simd, scalar));
+		}
+	}
+	return;
+}
+
+int main(void)
+{
+	TestAreaLargeDownscale();
+	TestAreaAgainstReference();
+	TestConvolutionAgainstReference();
+	TestConvolutionProperties();
+	TestResizeSIMD();
+	return test::Finish("ResizeTest");
+}
@@ -0,0 +1,80 @@
+//Shared helpers for the regression tests in this folder
+//Each test is a standalone program, build and run one from the repository root with e.g.
+//  g++ -std=c++11 -O2 -pthread -I. tests/ThreadPoolTest.cpp -o ThreadPoolTest && ./ThreadPoolTest
+//A test prints every failed check and returns 1 if any check failed
+#pragma once
+#define CG_HEADLESS
+#include "ConsoleGraphics.hpp"
+#include <cstdio>
+#include <random>
+
+namespace test
+{
+	static int failures = 0;
+
+	//Prints the failed expression with its location, the test keeps running
+	#define CG_CHECK(condition) test::Check((condition), #condition, __FILE__, __LINE__)
+	inline bool Check(bool condition, const char* expression, const char* file, int line)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED %s:%d: %s\n", file, line, expression);
+			++failures;
+		}
+		return condition;
+	}
+
+	inline int Finish(const char* name)
+	{
+		std::printf("%s: %s\n", name, failures == 0 ? "passed" : "FAILED");
+		return failures == 0 ? 0 : 1;
+	}
+
+	//Deterministic random numbers so failures can be reproduced
+	inline std::mt19937& Random(void)
+	{
+		static std::mt19937 random(1234);
+		return random;
+	}
+	inline uint32 RandomInt(uint32 limit)
+	{
+		return Random()() % limit;
+	}
+	inline float RandomFloat(float low, float high)
+	{
+		return low + ((high - low) * (Random()() / 4294967296.f));
+	}
+
+	//Image of random pixels, about a third of them are opaque and some are fully transparent
+	inline cg::Image RandomImage(uint32 width, uint32 height)
+	{
+		std::vector<cg::Pixel> pixels(width * height);
+		for (uint32 i = 0; i < pixels.size(); ++i)
+		{
+			uint32 argb = Random()();
+			if (i % 3 == 0){argb |= 0xFF000000;
+			}
+			else if (i % 7 == 0){argb &= 0x00FFFFFF;
+			}
+			pixels[i].setARGB(argb);
+		}
+		return cg::Image(pixels.data(), width, height);
+	}
+
+	inline bool SameBuffer(const uint32* a, const uint32* b, uint32 count, uint32 mask = 0xFFFFFFFF)
+	{
+		for (uint32 i = 0; i < count; ++i)
+		{
+			if ((a[i] & mask) != (b[i] & mask)){return false;
+			}
+		}
+		return true;
+	}
+	inline bool SameImage(const cg::Image& a, const cg::Image& b)
+	{
+		if (a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight()){return false;
+		}
+		const uint32 count = a.getWidth() * a.getHeight();
+		return count == 0 || memcmp(a.getPixelData(), b.getPixelData(), count * sizeof(cg::Pixel)) == 0;
+	}
+}
@@ -0,0 +1,137 @@
+//cg::ThreadPool scheduling and the ExecutionPolicy versions of the Image operations
+#include "TestCommon.hpp"
+#include <chrono>
+
+//Runs a loop and checks each index was visited exactly once in chunks no bigger than grain
+static bool CoversOnce(cg::ThreadPool& pool, uint32 count, uint32 grain)
+{
+	std::vector<std::atomic<uint32>> visits(count);
+	for (uint32 i = 0; i < count; ++i)
+	{
+		visits[i] = 0;
+	}
+	std::atomic<bool> chunksOk(true);
+	pool.parallelFor(count, grain, [&](uint32 begin, uint32 end)
+	{
+		if (end <= begin || end - begin > std::max<uint32>(grain, 1)){chunksOk = false;
+		}
+		for (uint32 i = begin; i < end; ++i)
+		{
+			++visits[i];
+		}
+	});
+	for (uint32 i = 0; i < count; ++i)
+	{
+		if (visits[i] != 1){return false;
+		}
+	}
+	return chunksOk;
+}
+
+static void TestScheduling(void)
+{
+	cg::ThreadPool pool(4);
+	for (uint32 i = 0; i < 500; ++i)
+	{
+		CG_CHECK(CoversOnce(pool, test::RandomInt(5000), test::RandomInt(64)));
+	}
+
+	//Nested loops run on the calling thread
+	std::atomic<uint32> total(0);
+	pool.parallelFor(64, 1, [&](uint32 begin, uint32 end)
+	{
+		for (uint32 i = begin; i < end; ++i)
+		{
+			pool.parallelFor(10, 1, [&](uint32 b, uint32 e){total += e - b;});
+		}
+	});
+	CG_CHECK(total == 640);
+	return;
+}
+
+//The pool is restarted between jobs, the new workers mustn't pick up the old job
+static void TestRestart(void)
+{
+	cg::ThreadPool pool(8);
+	CG_CHECK(CoversOnce(pool, 1000, 1));
+	pool.setThreadCount(2);
+	CG_CHECK(pool.getThreadCount() == 2);
+	//Gives the new worker time to wake up before the next job
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	CG_CHECK(CoversOnce(pool, 1000, 1));
+	for (uint32 i = 0; i < 50; ++i)
+	{
+		pool.setThreadCount(1 + test::RandomInt(8));
+		CG_CHECK(CoversOnce(pool, 1 + test::RandomInt(3000), 1 + test::RandomInt(16)));
+	}
+	pool.setThreadCount(1);
+	CG_CHECK(CoversOnce(pool, 100, 1));
+	return;
+}
+
+static void Fade(std::pair<uint32, uint8>* pixel, void*)
+{
+	pixel->first = (pixel->first * 7) ^ 0x123456;
+	pixel->second ^= 0x5A;
+	return;
+}
+static void Scramble(cg::Pixel* pixel, void*)
+{
+	pixel->setARGB((pixel->getARGB() * 13) + 1);
+	return;
+}
+
+//Every Image operation gives the same pixels with either policy
+static void TestImagePolicies(void)
+{
+	cg::ThreadPool::getShared().setThreadCount(4);
+	const uint32 sizes[][2] = {{1, 1}, {3, 7}, {64, 64}, {640, 480}, {1023, 517}, {0, 5}};
+	for (const auto& size : sizes)
+	{
+		const cg::Image source = test::RandomImage(size[0], size[1]);
+		auto same = [&](const std::function<void(cg::Image&, cg::ExecutionPolicy)>& operation)
+		{
+			cg::Image a = source, b = source;
+			operation(a, cg::ExecutionPolicy::Sequential);
+			operation(b, cg::ExecutionPolicy::Parallel);
+			return test::SameImage(a, b);
+		};
+		CG_CHECK(same([](cg::Image& i, cg::ExecutionPolicy p){i.filter(cg::FilterType::Grayscale, nullptr, nullptr, p);}));
+		CG_CHECK(same([](cg::Image& i, cg::ExecutionPolicy p){i.filter(cg::FilterType::WeightedGrayscale, nullptr, nullptr, p);}));
+		CG_CHECK(same([](cg::Image& i, cg::ExecutionPolicy p){i.filter(cg::FilterType::Invert, nullptr, nullptr, p);}));
+		CG_CHECK(same([](cg::Image& i, cg::ExecutionPolicy p){i.filter(cg::FilterType::Custom, Fade, nullptr, p);}));
+		CG_CHECK(same([](cg::Image& i, cg::ExecutionPolicy p){i.filter(Scramble, nullptr, p);}));
+		CG_CHECK(same([](cg::Image& i, cg::ExecutionPolicy p){i.flipVertically(p);}));
+		CG_CHECK(same([](cg::Image& i, cg::ExecutionPolicy p){i.flipHorizontally(p);}));
+		CG_CHECK(same([](cg::Image& i, cg::ExecutionPolicy p){i.setAlpha(77, p);}));
+		CG_CHECK(same([](cg::Image& i, cg::ExecutionPolicy p){i.setColourToAlpha(0x000000, 9, p);}));
+		if (size[0] == 0 || size[1] == 0){continue;
+		}
+		for (uint32 m = (uint32)cg::InterpolationMethod::NearestNeighbor; m <= (uint32)cg::InterpolationMethod::Lanczos3; ++m)
+		{
+			if (m == (uint32)cg::InterpolationMethod::Bisinusoidal && size[0] > 100){continue;
+			}
+			CG_CHECK(same([&](cg::Image& i, cg::ExecutionPolicy p){i.resize((size[0] * 3 / 2) + 1, (size[1] / 2) + 1, (cg::InterpolationMethod)m, p);}));
+			CG_CHECK(same([&](cg::Image& i, cg::ExecutionPolicy p){i.resize((size[0] / 3) + 1, (size[1] * 2) + 1, (cg::InterpolationMethod)m, p);}));
+		}
+
+		//Saving either way writes the same file, loading it either way gives the image back
+		cg::Image saved = source;
+		saved.saveImage("ThreadPoolTest.bmp", 0, cg::ExecutionPolicy::Parallel);
+		cg::Image sequential, parallel;
+		CG_CHECK(sequential.loadImage("ThreadPoolTest.bmp"));
+		CG_CHECK(parallel.loadImage("ThreadPoolTest.bmp", cg::ExecutionPolicy::Parallel));
+		CG_CHECK(test::SameImage(sequential, source));
+		CG_CHECK(test::SameImage(parallel, source));
+		std::remove("ThreadPoolTest.bmp");
+	}
+	return;
+}
+
+int main(void)
+{
+	TestScheduling();
+	TestRestart();
+	TestImagePolicies();
+	return test::Finish("ThreadPoolTest");
+}